@@ -1,32 +1,123 @@
 #include "ActionMap.h"
+#include "InputClock.h"
+#include "InputMetrics.h"
+#include "MappedFile.h"
+#include <filesystem>
 #include <fstream>          // 用于文件读取
-#include <iostream>         // 用于错误输出
+#include <unordered_set>
+#include "InputLog.h"        // 用于错误输出
 #include "nlohmann/json.hpp" // 用于解析JSON，需要用户确保此库可用
 
 // 使用 nlohmann/json 库的命名空间
 using json = nlohmann::json;
 
 void ActionMap::initialize(const std::string& bindingsFilePath) {
-    loadBindings(bindingsFilePath);
+    reload(bindingsFilePath);
 }
 
-void ActionMap::loadBindings(const std::string& filePath) {
+bool ActionMap::reload(const std::string& bindingsFilePath) {
+    std::lock_guard<std::mutex> lk(writerMtx);
+    std::shared_ptr<const BindingTable> current = table.share();
+    std::shared_ptr<const BindingTable> loaded =
+        loadCompiledBindings(compiledBindingsPath(bindingsFilePath), bindingsFilePath);
+    if (loaded && !loaded->preservesActionIds(*current)) {
+        // 预编译文件的动作编号与当前表不一致（例如删除过动作），改为以当前表为种子解析 JSON
+        loaded.reset();
+    }
+    if (!loaded) {
+        loaded = loadBindings(bindingsFilePath, current.get());
+    }
+    if (!loaded) {
+        InputMetrics::add(MetricCounter::BindingReloadFailures);
+        return false;
+    }
+    table.publish(std::move(loaded));
+    InputMetrics::add(MetricCounter::BindingReloads);
+    return true;
+}
+
+bool ActionMap::rebind(DeviceType device, int code, const std::vector<std::string>& actionNames) {
+    std::lock_guard<std::mutex> lk(writerMtx);
+    BindingTable::Builder builder(*table.share());
+    builder.clearBinding(device, code);
+    for (const std::string& actionName : actionNames) {
+        ActionId id = builder.findAction(actionName);
+        if (id == kInvalidActionId) {
+            InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings, "Cannot bind undefined action: ",
+                                         actionName);
+            InputMetrics::add(MetricCounter::BindingReloadFailures);
+            return false;
+        }
+        builder.addBinding(device, code, id);
+    }
+    table.publish(std::make_shared<const BindingTable>(builder.build()));
+    InputMetrics::add(MetricCounter::BindingReloads);
+    return true;
+}
+
+void ActionMap::publish(std::shared_ptr<const BindingTable> next) {
+    if (!next) return;
+    std::lock_guard<std::mutex> lk(writerMtx);
+    table.publish(std::move(next));
+    InputMetrics::add(MetricCounter::BindingReloads);
+}
+
+std::string ActionMap::compiledBindingsPath(const std::string& bindingsFilePath) {
+    return std::filesystem::path(bindingsFilePath).replace_extension(".bindc").string();
+}
+
+std::shared_ptr<const BindingTable> ActionMap::loadCompiledBindings(const std::string& imagePath,
+                                                                   const std::string& sourcePath) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(imagePath)) {
+        return nullptr; // 没有预编译文件属于正常情况，静默回退
+    }
+
+    std::string error;
+    BindingSourceStamp recorded;
+    std::shared_ptr<const BindingTable> loaded = BindingTable::fromImage(std::move(file), error, &recorded);
+    if (!loaded) {
+        InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings, "Ignoring compiled bindings ",
+                                     imagePath + ": " + error);
+        return nullptr;
+    }
+
+    // 源 JSON 存在且与编译时不一致，说明预编译文件已过期
+    BindingSourceStamp current;
+    if (BindingSourceStamp::of(sourcePath, current) && current != recorded) {
+        InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings, "Compiled bindings are stale: ",
+                                     imagePath + ", parsing " + sourcePath);
+        return nullptr;
+    }
+    return loaded;
+}
+
+std::shared_ptr<const BindingTable> ActionMap::loadBindings(const std::string& filePath,
+                                                            const BindingTable* base) {
     std::ifstream f(filePath);
     if (!f.is_open()) {
-        std::cerr << "Error: Could not open bindings file: " << filePath << std::endl;
-        return;
+        InputLog::instance().message(LogLevel::Error, LogCategory::Bindings, "Could not open bindings file: ",
+                                     filePath);
+        return nullptr;
     }
 
     try {
         json data = json::parse(f);
+        BindingTable::Builder builder;
+        if (base) builder.internActionsOf(*base);
+        // 本文件定义的动作：种子中已被删除的动作保留编号，但不能再被绑定或用于连招
+        std::unordered_set<std::string> defined;
+        std::vector<std::pair<std::string, ActionId>> addedCombos;
+        auto findDefined = [&](const std::string& name) {
+            return defined.count(name) ? builder.findAction(name) : kInvalidActionId;
+        };
 
-        // 解析定义的动作
+        // 解析定义的动作，动作名在此驻留为 ActionId
         if (data.contains("actions") && data["actions"].is_object()) {
             for (auto& [actionName, actionDetails] : data["actions"].items()) {
-                GameAction ga;
-                ga.name = actionName;
                 // 可以从 actionDetails 中读取更多属性
-                definedActions[actionName] = ga;
+                builder.internAction(actionName);
+                defined.insert(actionName);
             }
         }
 
@@ -37,7 +128,8 @@ void ActionMap::loadBindings(const std::string& filePath) {
                 if (deviceTypeStr == "Keyboard") dt = DeviceType::Keyboard;
                 else if (deviceTypeStr == "Touch") dt = DeviceType::Touch;
                 else {
-                    std::cerr << "Warning: Unknown device type in bindings: " << deviceTypeStr << std::endl;
+                    InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings,
+                                                 "Unknown device type in bindings: ", deviceTypeStr);
                     continue;
                 }
 
@@ -49,38 +141,108 @@ void ActionMap::loadBindings(const std::string& filePath) {
                                 for (const auto& actionNameJson : actionNames) {
                                     if (actionNameJson.is_string()) {
                                         std::string actionName = actionNameJson.get<std::string>();
-                                        if (definedActions.count(actionName)) { // 确保动作已定义
-                                            bindings[{dt, inputCode}].push_back(actionName);
+                                        ActionId id = findDefined(actionName);
+                                        if (id != kInvalidActionId) { // 确保动作已定义
+                                            builder.addBinding(dt, inputCode, id);
                                         } else {
-                                            std::cerr << "Warning: Action '" << actionName << "' not defined, but used in binding." << std::endl;
+                                            InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings,
+                                                                         "Action not defined, but used in binding: ",
+                                                                         actionName);
                                         }
                                     }
                                 }
                             }
                         } catch (const std::invalid_argument& ia) {
-                            std::cerr << "Warning: Invalid input code in bindings: " << inputCodeStr << std::endl;
+                            InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings,
+                                                         "Invalid input code in bindings: ", inputCodeStr);
                         }
                     }
                 }
             }
         }
+
+        // 解析连招：连招名驻留为动作，识别成功时作为合成动作发出
+        //   "Hadouken": {"sequence": ["MoveBackward", "MoveForward", "Attack"], "window": 300}
+        //   "Slam":     {"chord": ["Jump", "Attack"], "window": 50}
+        if (data.contains("combos") && data["combos"].is_object()) {
+            for (auto& [comboName, comboJson] : data["combos"].items()) {
+                ComboDefinition combo;
+                const json* steps = nullptr;
+                uint64_t defaultWindowMs = 300;
+                if (comboJson.contains("sequence") && comboJson["sequence"].is_array()) {
+                    combo.kind = ComboKind::Sequence;
+                    steps = &comboJson["sequence"];
+                } else if (comboJson.contains("chord") && comboJson["chord"].is_array()) {
+                    combo.kind = ComboKind::Chord;
+                    steps = &comboJson["chord"];
+                    defaultWindowMs = 50;
+                } else {
+                    InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings,
+                                                 "Combo needs a 'sequence' or 'chord' array: ", comboName);
+                    continue;
+                }
+                uint64_t windowMs = comboJson.value("window", defaultWindowMs);
+                combo.windowNanos = windowMs * kNanosPerMilli;
+
+                bool valid = !steps->empty();
+                for (const auto& stepJson : *steps) {
+                    ActionId id = stepJson.is_string() ? findDefined(stepJson.get<std::string>())
+                                                       : kInvalidActionId;
+                    if (id == kInvalidActionId) {
+                        InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings,
+                                                     "Combo uses undefined action: ",
+                                                     comboName + " -> " + stepJson.dump());
+                        valid = false;
+                        break;
+                    }
+                    combo.steps.push_back(id);
+                }
+                if (!valid) continue;
+                combo.action = builder.internAction(comboName);
+                defined.insert(comboName);
+                addedCombos.emplace_back(comboName, combo.action);
+                builder.addCombo(std::move(combo));
+            }
+        }
+
+        auto built = std::make_shared<const BindingTable>(builder.build());
+        // 超出回滚快照容量的连招在编译时被丢弃（见 ComboAutomaton::kMaxSequenceSteps / kMaxChordSlots）
+        if (built->combos().combos().size() != addedCombos.size()) {
+            std::unordered_set<ActionId> compiled;
+            for (const ComboDefinition& combo : built->combos().combos()) compiled.insert(combo.action);
+            for (const auto& [comboName, id] : addedCombos) {
+                if (!compiled.count(id)) {
+                    InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings,
+                                                 "Combo exceeds rollback snapshot limits, ignored: ", comboName);
+                }
+            }
+        }
+        return built;
     } catch (json::parse_error& e) {
-        std::cerr << "Error parsing JSON bindings file: " << filePath << "\n" << e.what() << std::endl;
+        InputLog::instance().message(LogLevel::Error, LogCategory::Bindings, "Could not parse JSON bindings file: ",
+                                     filePath + "\n" + e.what());
+    } catch (json::type_error& e) {
+        InputLog::instance().message(LogLevel::Error, LogCategory::Bindings, "Invalid value in bindings file: ",
+                                     filePath + "\n" + e.what());
     }
-    f.close();
+    return nullptr;
 }
 
 std::vector<GameAction> ActionMap::getActions(const DeviceEvent& event) const {
+    BindingSnapshot bindings = snapshot();
     std::vector<GameAction> resultingActions;
-    auto it = bindings.find({event.device, event.code});
-    if (it != bindings.end()) {
-        const auto& actionNameList = it->second;
-        for (const std::string& actionName : actionNameList) {
-            auto definedActionIt = definedActions.find(actionName);
-            if (definedActionIt != definedActions.end()) {
-                resultingActions.push_back(definedActionIt->second);
-            }
-        }
+    for (ActionId id : bindings->lookup(event.device, event.code)) {
+        resultingActions.push_back(bindings->action(id));
     }
     return resultingActions;
+}
+
+std::map<std::pair<DeviceType, int>, std::vector<std::string>> ActionMap::getAllBindings() const {
+    BindingSnapshot bindings = snapshot();
+    std::map<std::pair<DeviceType, int>, std::vector<std::string>> result;
+    bindings->forEachBinding([&](DeviceType device, int code, ActionIdSpan ids) {
+        std::vector<std::string>& names = result[{device, code}];
+        for (ActionId id : ids) names.push_back(bindings->action(id).name);
+    });
+    return result;
 }
\ No newline at end of file
@@ -1,16 +1,28 @@
 #ifndef ACTION_MAP_H
 #define ACTION_MAP_H
 
+#include "BindingTable.h"
 #include "DeviceEvent.h"
+#include "Rcu.h"
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <map>
 #include <utility> // For std::pair
 
-// 代表一个逻辑动作，例如 "Attack", "Jump"
-struct GameAction {
-    std::string name;
-    // 可以添加其他与动作相关的属性，如是否是持续性动作等
+// 绑定表快照：持有期间当前线程处于 RCU 读侧，表不会被回收。
+// 获取与释放各只有一次原子写，不会阻塞，也不会看到构建到一半的表。
+class BindingSnapshot {
+public:
+    explicit BindingSnapshot(const RcuCell<BindingTable>& cell) : table(cell.get()) {}
+
+    const BindingTable& operator*() const { return *table; }
+    const BindingTable* operator->() const { return table; }
+
+private:
+    RcuReadGuard guard; // 必须先于 table 初始化
+    const BindingTable* table;
 };
 
 // 将物理输入映射到逻辑动作
@@ -25,25 +37,67 @@ public:
     // 初始化动作映射（从配置文件加载）
     void initialize(const std::string& bindingsFilePath);
 
-    // 根据设备事件获取所有对应的动作
+    // 热重载：在调用线程上构建新表，成功后原子发布；失败时保留当前绑定。
+    // 正在进行的查询不会被阻塞，也不会看到构建到一半的表。
+    // 已有动作保持原 ActionId（命令处理函数、动作状态、连招进度、命令队列中的命令
+    // 与日志都按编号引用动作），新动作排在其后；从配置中删除的动作保留编号，只是不再有绑定。
+    // 若存在未过期、且保留了当前全部动作编号的预编译绑定文件（见 compiledBindingsPath），
+    // 直接映射使用，否则回退到解析 JSON。
+    bool reload(const std::string& bindingsFilePath);
+
+    // 运行时改键：把 (device, code) 重新绑定到 actionNames（为空则解除绑定）
+    bool rebind(DeviceType device, int code, const std::vector<std::string>& actionNames);
+
+    // 发布一张新构建的绑定表
+    void publish(std::shared_ptr<const BindingTable> table);
+
+    // 获取当前绑定表的快照；热路径应每帧获取一次并在整帧内使用
+    BindingSnapshot snapshot() const { return BindingSnapshot(table); }
+
+    // 共享当前绑定表的所有权（如供多个会话长期持有）
+    std::shared_ptr<const BindingTable> shareBindings() const { return table.share(); }
+
+    // 以下便捷接口直接读取当前表。返回的视图/引用只在调用方持有 snapshot()
+    // 期间有效；不持有快照时，调用方需保证没有并发的 reload/rebind。
+
+    // 热路径：根据设备事件获取所有对应的动作编号，不分配内存
+    ActionIdSpan getActionIds(const DeviceEvent& event) const {
+        return table.get()->lookup(event.device, event.code);
+    }
+
+    // 根据动作编号获取动作定义
+    const GameAction& getAction(ActionId id) const { return table.get()->action(id); }
+    ActionId findActionId(const std::string& name) const { return snapshot()->findAction(name); }
+    size_t actionCount() const { return snapshot()->actionCount(); }
+
+    // 兼容接口：根据设备事件获取所有对应的动作（会复制动作名，较慢）
     std::vector<GameAction> getActions(const DeviceEvent& event) const;
 
     // 获取所有绑定
-    std::map<std::pair<DeviceType, int>, std::vector<std::string>> getAllBindings() const { return bindings; }
+    std::map<std::pair<DeviceType, int>, std::vector<std::string>> getAllBindings() const;
+
+    // 解析 JSON 绑定文件，只构建不发布（离线编译工具 bindc 也使用它）。
+    // base 非空时先按 base 的编号驻留其全部动作，保证同名动作编号不变
+    static std::shared_ptr<const BindingTable> loadBindings(const std::string& filePath,
+                                                            const BindingTable* base = nullptr);
+
+    // 映射预编译绑定文件；文件缺失、损坏或相对 sourcePath 已过期时返回 nullptr
+    static std::shared_ptr<const BindingTable> loadCompiledBindings(const std::string& imagePath,
+                                                                    const std::string& sourcePath);
+
+    // JSON 绑定文件对应的预编译文件路径，例如 bindings.json -> bindings.bindc
+    static std::string compiledBindingsPath(const std::string& bindingsFilePath);
 
 private:
     // 私有构造函数，防止外部创建实例
-    ActionMap() = default;
+    ActionMap() : table(std::make_shared<const BindingTable>()) {}
     // 禁止拷贝和赋值
     ActionMap(const ActionMap&) = delete;
     ActionMap& operator=(const ActionMap&) = delete;
 
-    // 存储绑定规则：(DeviceType, input_code) -> list_of_action_names
-    std::map<std::pair<DeviceType, int>, std::vector<std::string>> bindings;
-    // 存储动作定义：action_name -> GameAction
-    std::map<std::string, GameAction> definedActions;
-
-    void loadBindings(const std::string& filePath);
+    // 热路径使用的扁平绑定表（动作名已驻留为 ActionId），通过 RCU 发布
+    RcuCell<BindingTable> table;
+    std::mutex writerMtx; // 串行化 reload / rebind，不影响读者
 };
 
 #endif // ACTION_MAP_H
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "ActionState.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+void ActionState::endFrame() {
+    RcuDomain& domain = RcuDomain::instance();
+
+    // 下一块可写的缓冲只能是第三块；调用线程若持有早于它被替换下来的读侧临界区，
+    // 下面的等待永远不会结束。在改动任何状态之前报错
+    static_assert(kBufferCount == 3, "spare buffer index assumes triple buffering");
+    const size_t spare = 3 - writeIndex - publishedIndex;
+    if (domain.currentThreadBlocks(retiredEpoch[spare])) {
+        throw std::logic_error("ActionState::endFrame called inside a read-side critical section "
+                               "that spans the previous endFrame");
+    }
+
+    // 发布写好的帧；被替换下来的帧要等到宽限期结束后才能再写
+    const size_t retired = publishedIndex;
+    published.store(&frames[writeIndex], std::memory_order_seq_cst);
+    publishedIndex = writeIndex;
+    retiredEpoch[retired] = domain.advance();
+
+    // 选一块既不是已发布帧、旧读者也都已离开的缓冲。读者只做几次位运算，
+    // 正常情况下第一次检查就能通过；读者跨帧持有视图时才需要等待
+    size_t next = publishedIndex;
+    for (;;) {
+        for (size_t i = 0; i < kBufferCount; ++i) {
+            if (i != publishedIndex && domain.quiescentSince(retiredEpoch[i])) {
+                next = i;
+                break;
+            }
+        }
+        if (next != publishedIndex) break;
+        std::this_thread::yield();
+    }
+
+    ActionFrame& frame = frames[next];
+    frame = frames[publishedIndex];
+    frame.frameNumber += 1;
+    std::fill(std::begin(frame.pressed), std::end(frame.pressed), 0);
+    std::fill(std::begin(frame.released), std::end(frame.released), 0);
+    writeIndex = next;
+}
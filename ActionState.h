@@ -0,0 +1,122 @@
+#ifndef ACTION_STATE_H
+#define ACTION_STATE_H
+
+#include "BindingTable.h"
+#include "DeviceEvent.h"
+#include "Rcu.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 一帧的动作状态（POD，可整体拷贝）：按 ActionId 索引的位集与模拟量数组。
+//   pressed  本帧内由松开变为按下
+//   held     当前处于按下状态
+//   released 本帧内由按下变为松开
+//   values   最近一次的模拟量（方向/摇杆/压力），松开后为 0
+// 编号不小于 kMaxActions 的动作不记录状态。
+struct ActionFrame {
+    static constexpr size_t kMaxActions = 1024;
+    static constexpr size_t kWords = kMaxActions / 64;
+
+    uint64_t frameNumber = 0;
+    uint64_t timestamp = 0; // 本帧最后一个事件的时间戳
+    uint64_t pressed[kWords] = {};
+    uint64_t held[kWords] = {};
+    uint64_t released[kWords] = {};
+    float values[kMaxActions] = {};
+
+    static bool test(const uint64_t* bits, ActionId id) {
+        return id < kMaxActions && ((bits[id >> 6] >> (id & 63)) & 1);
+    }
+
+    bool isPressed(ActionId id) const { return test(pressed, id); }
+    bool isHeld(ActionId id) const { return test(held, id); }
+    bool isReleased(ActionId id) const { return test(released, id); }
+    float value(ActionId id) const { return id < kMaxActions ? values[id] : 0.0f; }
+};
+
+// 已发布帧的只读视图：持有期间处于 RCU 读侧，帧缓冲不会被复用。
+// 不加锁、不等待；不要跨帧长期持有。
+class ActionStateView {
+public:
+    explicit ActionStateView(const std::atomic<const ActionFrame*>& published)
+        : frame(published.load(std::memory_order_seq_cst)) {}
+
+    const ActionFrame& operator*() const { return *frame; }
+    const ActionFrame* operator->() const { return frame; }
+
+private:
+    RcuReadGuard guard; // 必须先于 frame 初始化
+    const ActionFrame* frame;
+};
+
+// 动作状态快照：InputProcessor 在处理事件时更新当前帧，endFrame() 时发布。
+// 游戏线程通过 read() 无锁读取最近发布的一帧，也可以像轮询按键一样查询某个动作。
+//
+// 内部是固定的三块帧缓冲：一块正在写，一块已发布，另一块等待旧读者离开
+// （用 RCU 宽限期判断），写侧不分配内存。
+class ActionState {
+public:
+    ActionState() : published(&frames[0]) { frames[writeIndex].frameNumber = 1; }
+    ActionState(const ActionState&) = delete;
+    ActionState& operator=(const ActionState&) = delete;
+
+    // ---- 写侧：只能由处理输入的线程调用 ----
+
+    // 根据事件更新动作：按下类事件置 pressed/held，松开类事件置 released
+    void apply(ActionId id, const DeviceEvent& event) {
+        if (id >= ActionFrame::kMaxActions) return;
+        ActionFrame& frame = frames[writeIndex];
+        const uint64_t bit = uint64_t{1} << (id & 63);
+        const size_t word = id >> 6;
+        if (isPressEvent(event)) {
+            if (!(frame.held[word] & bit)) frame.pressed[word] |= bit;
+            frame.held[word] |= bit;
+            frame.values[id] = event.value;
+        } else {
+            if (frame.held[word] & bit) frame.released[word] |= bit;
+            frame.held[word] &= ~bit;
+            frame.values[id] = 0.0f;
+        }
+        if (event.timestamp > frame.timestamp) frame.timestamp = event.timestamp;
+    }
+
+    // 瞬时动作（如连招）：本帧内按下并松开，不保持
+    void pulse(ActionId id, uint64_t timestamp) {
+        if (id >= ActionFrame::kMaxActions) return;
+        ActionFrame& frame = frames[writeIndex];
+        const uint64_t bit = uint64_t{1} << (id & 63);
+        frame.pressed[id >> 6] |= bit;
+        frame.released[id >> 6] |= bit;
+        if (timestamp > frame.timestamp) frame.timestamp = timestamp;
+    }
+
+    // 正在构建的帧（只能在写线程上读取）
+    const ActionFrame& pending() const { return frames[writeIndex]; }
+
+    // 用保存的帧替换正在构建的帧（回滚）；已发布的帧不变，下一次 endFrame 时被替换
+    void restorePending(const ActionFrame& saved) { frames[writeIndex] = saved; }
+
+    // 发布当前帧并开始下一帧：held 与模拟量延续，边沿位清零。
+    // 调用线程持有的读侧临界区（如 BindingSnapshot、ActionStateView）不能跨越上一次
+    // endFrame，否则要等待自己离开而死锁；检测到时抛出 std::logic_error，状态不变
+    void endFrame();
+
+    // ---- 读侧：任意线程 ----
+
+    // 最近发布的一帧
+    ActionStateView read() const { return ActionStateView(published); }
+
+    uint64_t publishedFrameNumber() const { return read()->frameNumber; }
+
+private:
+    static constexpr size_t kBufferCount = 3;
+
+    ActionFrame frames[kBufferCount];
+    uint64_t retiredEpoch[kBufferCount] = {}; // 该缓冲被替换下来时的纪元
+    std::atomic<const ActionFrame*> published;
+    size_t writeIndex = 1;
+    size_t publishedIndex = 0;
+};
+
+#endif // ACTION_STATE_H
@@ -0,0 +1,313 @@
+#include "AnalogConditioner.h"
+#include "InputLog.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+using json = nlohmann::json;
+
+namespace {
+constexpr float kFirstSampleDt = 1e-3f; // 通道的第一个采样没有间隔，按 1kHz 计
+constexpr float kMinDt = 1e-6f;         // 时间戳相同或倒退时的最小间隔
+} // namespace
+
+void AnalogConditioner::setProfile(DeviceType device, int code, const AnalogProfile& profile) {
+    uint32_t index = findChannel(makeKey(device, code));
+    if (index == kNoChannel) {
+        index = static_cast<uint32_t>(channels.size());
+        channels.push_back(Channel{device, code, profile});
+        rebuildIndex();
+    }
+    channels[index].profile = profile;
+    rebuildArrays();
+}
+
+void AnalogConditioner::clearProfiles() {
+    channels.clear();
+    slots.clear();
+    slotMask = 0;
+    rebuildArrays();
+}
+
+void AnalogConditioner::rebuildIndex() {
+    // 装载率不超过 50%，保证查找时总能遇到空槽
+    size_t capacity = 16;
+    while (capacity < channels.size() * 2) capacity <<= 1;
+    slots.assign(capacity, Slot{});
+    slotMask = capacity - 1;
+    for (uint32_t c = 0; c < channels.size(); ++c) {
+        const uint64_t key = makeKey(channels[c].device, channels[c].code);
+        size_t i = hashKey(key) & slotMask;
+        while (slots[i].channel != kNoChannel) i = (i + 1) & slotMask;
+        slots[i] = Slot{key, c};
+    }
+}
+
+void AnalogConditioner::rebuildArrays() {
+    const size_t n = channels.size();
+    ChannelArrays& a = arrays;
+    a.cutoff.resize(n);
+    a.beta.resize(n);
+    a.slopeCutoff.resize(n);
+    a.deadzone.resize(n);
+    a.invRange.resize(n);
+    a.curve.resize(n);
+    a.radial.resize(n);
+    a.partner.resize(n);
+    a.smoothed.resize(n);
+    for (uint32_t c = 0; c < n; ++c) {
+        const AnalogProfile& profile = channels[c].profile;
+        a.cutoff[c] = profile.cutoff;
+        a.beta[c] = profile.smoothing == AnalogSmoothing::OneEuro ? profile.beta : 0.0f;
+        a.slopeCutoff[c] = profile.slopeCutoff;
+        a.deadzone[c] = profile.deadzone;
+        a.invRange[c] = 1.0f / std::max(profile.outerDeadzone - profile.deadzone, 1e-6f);
+        a.curve[c] = profile.curve;
+        a.smoothed[c] = profile.smoothing != AnalogSmoothing::None;
+
+        a.partner[c] = c;
+        if (profile.radialPair >= 0) {
+            const uint32_t partner = findChannel(makeKey(channels[c].device, profile.radialPair));
+            if (partner != kNoChannel) a.partner[c] = partner;
+        }
+        a.radial[c] = a.partner[c] != c ? 1.0f : 0.0f;
+    }
+    reset();
+}
+
+void AnalogConditioner::reset() {
+    const size_t n = channels.size();
+    arrays.lastTimestamp.assign(n, 0);
+    arrays.filtered.assign(n, 0.0f);
+    arrays.slope.assign(n, 0.0f);
+    arrays.current.assign(n, 0.0f);
+}
+
+bool AnalogConditioner::loadProfiles(const std::string& path) {
+    std::ifstream f(path);
+    if (!f.is_open()) {
+        InputLog::instance().message(LogLevel::Error, LogCategory::Bindings, "Could not open bindings file: ", path);
+        return false;
+    }
+
+    // 先解析到临时对象，成功后再替换，解析失败时保留原配置
+    AnalogConditioner loaded;
+    try {
+        json data = json::parse(f);
+        // "analog": {"Touch": {"1001": {"deadzone": 0.1, "curve": 0.5, "radialPair": 1002,
+        //                              "smoothing": "oneEuro", "cutoff": 1.0, "beta": 0.05}}}
+        if (data.contains("analog") && data["analog"].is_object()) {
+            for (auto& [deviceTypeStr, deviceProfiles] : data["analog"].items()) {
+                DeviceType dt;
+                if (deviceTypeStr == "Keyboard") dt = DeviceType::Keyboard;
+                else if (deviceTypeStr == "Touch") dt = DeviceType::Touch;
+                else {
+                    InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings,
+                                                 "Unknown device type in analog profiles: ", deviceTypeStr);
+                    continue;
+                }
+                if (!deviceProfiles.is_object()) continue;
+
+                for (auto& [inputCodeStr, profileJson] : deviceProfiles.items()) {
+                    int inputCode;
+                    try {
+                        inputCode = std::stoi(inputCodeStr);
+                    } catch (const std::exception&) {
+                        InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings,
+                                                     "Invalid input code in analog profiles: ", inputCodeStr);
+                        continue;
+                    }
+
+                    AnalogProfile profile;
+                    profile.deadzone = profileJson.value("deadzone", profile.deadzone);
+                    profile.outerDeadzone = profileJson.value("outerDeadzone", profile.outerDeadzone);
+                    profile.curve = std::min(std::max(profileJson.value("curve", profile.curve), 0.0f), 1.0f);
+                    profile.radialPair = profileJson.value("radialPair", profile.radialPair);
+                    profile.cutoff = profileJson.value("cutoff", profile.cutoff);
+                    profile.beta = profileJson.value("beta", profile.beta);
+                    profile.slopeCutoff = profileJson.value("slopeCutoff", profile.slopeCutoff);
+
+                    std::string smoothing = profileJson.value("smoothing", std::string("none"));
+                    if (smoothing == "lowPass") profile.smoothing = AnalogSmoothing::LowPass;
+                    else if (smoothing == "oneEuro") profile.smoothing = AnalogSmoothing::OneEuro;
+                    else if (smoothing != "none") {
+                        InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings,
+                                                     "Unknown smoothing for analog input, smoothing disabled: ",
+                                                     inputCodeStr + " -> " + smoothing);
+                    }
+                    loaded.setProfile(dt, inputCode, profile);
+                }
+            }
+        }
+    } catch (json::parse_error& e) {
+        InputLog::instance().message(LogLevel::Error, LogCategory::Bindings, "Could not parse JSON bindings file: ",
+                                     path + "\n" + e.what());
+        return false;
+    } catch (json::type_error& e) {
+        InputLog::instance().message(LogLevel::Error, LogCategory::Bindings, "Invalid value in bindings file: ",
+                                     path + "\n" + e.what());
+        return false;
+    }
+
+    for (uint32_t c = 0; c < loaded.channels.size(); ++c) {
+        const Channel& channel = loaded.channels[c];
+        if (channel.profile.radialPair >= 0 && loaded.arrays.partner[c] == c) {
+            InputLog::instance().message(LogLevel::Warning, LogCategory::Bindings,
+                                         "Radial pair has no analog profile, using an axial deadzone: ",
+                                         std::to_string(channel.code) + " -> " +
+                                             std::to_string(channel.profile.radialPair));
+        }
+    }
+    channels = std::move(loaded.channels);
+    arrays = std::move(loaded.arrays);
+    slots = std::move(loaded.slots);
+    slotMask = loaded.slotMask;
+    return true;
+}
+
+size_t AnalogConditioner::condition(std::vector<DeviceEvent>& events) {
+    sampleEvent.clear();
+    sampleChannel.clear();
+    sampleTime.clear();
+    sampleValue.clear();
+    if (channels.empty()) return 0;
+
+    // 收集需要调理的采样
+    for (size_t i = 0; i < events.size(); ++i) {
+        const DeviceEvent& event = events[i];
+        if (event.type != EventType::Directional) continue;
+        const uint32_t channel = findChannel(makeKey(event.device, event.code));
+        if (channel == kNoChannel) continue;
+        sampleEvent.push_back(static_cast<uint32_t>(i));
+        sampleChannel.push_back(channel);
+        sampleTime.push_back(event.timestamp);
+        sampleValue.push_back(event.value);
+    }
+    if (sampleEvent.empty()) return 0;
+
+    smoothSamples();
+    shapeSamples();
+
+    for (size_t s = 0; s < sampleEvent.size(); ++s) {
+        DeviceEvent& event = events[sampleEvent[s]];
+        // 原始值为 0 是松开：输出必须恰好为 0，否则下游会把它当作仍在按下
+        if (event.value != 0.0f) event.value = sampleValue[s];
+    }
+    return sampleEvent.size();
+}
+
+void AnalogConditioner::smoothSamples() {
+    const size_t n = sampleEvent.size();
+    ChannelArrays& a = arrays;
+    laneSample.resize(n);
+    laneInput.resize(n);
+    laneDt.resize(n);
+    laneMinCutoff.resize(n);
+    laneBeta.resize(n);
+    laneSlopeCutoff.resize(n);
+    laneValue.resize(n);
+    laneSlope.resize(n);
+    laneStamp.resize(channels.size(), 0);
+
+    // 按事件顺序把采样放入当前批次，遇到批次中已有的通道时先计算并写回当前批次，
+    // 这样同一通道的采样总是依次处理，不同通道在同一批次内并行
+    size_t lanes = 0;
+    auto flush = [&]() {
+        if (lanes == 0) return;
+        SmoothBatch batch;
+        batch.count = lanes;
+        batch.input = laneInput.data();
+        batch.dt = laneDt.data();
+        batch.minCutoff = laneMinCutoff.data();
+        batch.beta = laneBeta.data();
+        batch.slopeCutoff = laneSlopeCutoff.data();
+        batch.value = laneValue.data();
+        batch.slope = laneSlope.data();
+        kernels->smooth(batch);
+
+        for (size_t k = 0; k < lanes; ++k) {
+            const uint32_t s = laneSample[k];
+            const uint32_t c = sampleChannel[s];
+            a.filtered[c] = laneValue[k];
+            a.slope[c] = laneSlope[k];
+            sampleValue[s] = laneValue[k];
+        }
+        lanes = 0;
+        if (++batchStamp == 0) {
+            // 批次编号回绕时清空，避免旧编号被误认为当前批次
+            std::fill(laneStamp.begin(), laneStamp.end(), 0);
+            batchStamp = 1;
+        }
+    };
+
+    for (size_t s = 0; s < n; ++s) {
+        const uint32_t c = sampleChannel[s];
+        if (!a.smoothed[c]) continue;
+        if (sampleValue[s] == 0.0f) {
+            // 松开：不经过滤波，并清空该通道的平滑状态，下一次按下从头开始
+            if (laneStamp[c] == batchStamp) flush();
+            a.lastTimestamp[c] = 0;
+            a.filtered[c] = 0.0f;
+            a.slope[c] = 0.0f;
+            continue;
+        }
+        if (laneStamp[c] == batchStamp) flush();
+        laneStamp[c] = batchStamp;
+
+        const float x = sampleValue[s];
+        const uint64_t last = a.lastTimestamp[c];
+        float dt = kFirstSampleDt;
+        if (last == 0) {
+            // 第一个采样直接作为初始平滑值
+            a.filtered[c] = x;
+            a.slope[c] = 0.0f;
+        } else {
+            dt = sampleTime[s] > last ? std::max(static_cast<float>(sampleTime[s] - last) * 1e-9f, kMinDt)
+                                      : kMinDt;
+        }
+        a.lastTimestamp[c] = std::max<uint64_t>(sampleTime[s], 1);
+
+        laneSample[lanes] = static_cast<uint32_t>(s);
+        laneInput[lanes] = x;
+        laneDt[lanes] = dt;
+        laneMinCutoff[lanes] = a.cutoff[c];
+        laneBeta[lanes] = a.beta[c];
+        laneSlopeCutoff[lanes] = a.slopeCutoff[c];
+        laneValue[lanes] = a.filtered[c];
+        laneSlope[lanes] = a.slope[c];
+        ++lanes;
+    }
+    flush();
+}
+
+void AnalogConditioner::shapeSamples() {
+    const size_t n = sampleEvent.size();
+    ChannelArrays& a = arrays;
+    shapePartner.resize(n);
+    shapeRadial.resize(n);
+    shapeDeadzone.resize(n);
+    shapeInvRange.resize(n);
+    shapeCurve.resize(n);
+
+    // 径向死区读取另一轴在该采样时刻的最新值，因此按事件顺序收集参数
+    for (size_t s = 0; s < n; ++s) {
+        const uint32_t c = sampleChannel[s];
+        a.current[c] = sampleValue[s];
+        shapePartner[s] = a.current[a.partner[c]];
+        shapeRadial[s] = a.radial[c];
+        shapeDeadzone[s] = a.deadzone[c];
+        shapeInvRange[s] = a.invRange[c];
+        shapeCurve[s] = a.curve[c];
+    }
+
+    ShapeBatch batch;
+    batch.count = n;
+    batch.value = sampleValue.data();
+    batch.partner = shapePartner.data();
+    batch.radial = shapeRadial.data();
+    batch.deadzone = shapeDeadzone.data();
+    batch.invRange = shapeInvRange.data();
+    batch.curve = shapeCurve.data();
+    kernels->shape(batch);
+}
@@ -0,0 +1,127 @@
+#ifndef ANALOG_CONDITIONER_H
+#define ANALOG_CONDITIONER_H
+
+#include "AnalogKernels.h"
+#include "DeviceEvent.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 平滑方式
+enum class AnalogSmoothing : uint8_t {
+    None,
+    LowPass, // 固定截止频率的一阶低通
+    OneEuro  // 1-euro：慢速时强平滑去抖，快速移动时降低平滑减少延迟
+};
+
+// 一个模拟轴的调理参数（按 设备 + 输入码 配置）
+struct AnalogProfile {
+    float deadzone = 0.0f;      // 内死区：幅度低于此值输出 0
+    float outerDeadzone = 1.0f; // 外死区：幅度高于此值输出满量程
+    float curve = 0.0f;         // 响应曲线：0 线性，1 纯三次，中间为两者混合
+    int radialPair = -1;        // 同一摇杆另一轴的输入码；设置后使用径向死区
+    AnalogSmoothing smoothing = AnalogSmoothing::None;
+    float cutoff = 1.0f;        // 截止频率（Hz）；1-euro 时为最小截止频率
+    float beta = 0.0f;          // 1-euro 速度系数
+    float slopeCutoff = 1.0f;   // 1-euro 变化率的截止频率（Hz）
+};
+
+// 模拟量调理：位于 DeviceManager::pollEvents 与 EventCoalescer 之间，
+// 对配置了调理参数的方向/轴事件（EventType::Directional）原地改写 value：
+// 先对原始采样做平滑，再应用（径向或轴向）死区与响应曲线。
+// 原始值为 0 的采样（松开）原样输出 0，并清空该通道的平滑状态。
+//
+// 一帧的采样先收集为结构数组，再交给 SIMD 内核批量计算。平滑是逐通道递推的，
+// 因此按批处理：一个批次内每个通道至多一个采样，各通道互不相关。
+// 缓冲区帧间复用，稳定后不再分配内存。
+class AnalogConditioner {
+public:
+    AnalogConditioner() : kernels(&AnalogKernels::best()) {}
+
+    // 为 (设备, 输入码) 设置调理参数，清空所有通道的平滑状态
+    void setProfile(DeviceType device, int code, const AnalogProfile& profile);
+    void clearProfiles();
+    size_t profileCount() const { return channels.size(); }
+
+    // 从绑定文件的 "analog" 段加载调理参数（替换现有配置）。失败时保留原配置并返回 false
+    bool loadProfiles(const std::string& path);
+
+    // 原地调理一帧事件，返回被调理的事件数
+    size_t condition(std::vector<DeviceEvent>& events);
+
+    // 清空平滑状态（例如设备重新连接、回放开始）
+    void reset();
+
+    // 强制使用指定指令集（基准测试与对比用）；默认使用 CPU 支持的最高级别
+    void setSimdLevel(SimdLevel level) { kernels = &AnalogKernels::select(level); }
+    SimdLevel simdLevel() const { return kernels->level; }
+
+private:
+    static constexpr uint32_t kNoChannel = UINT32_MAX;
+
+    // 通道配置（冷数据）
+    struct Channel {
+        DeviceType device;
+        int code;
+        AnalogProfile profile;
+    };
+
+    // 按通道下标索引的参数与平滑状态（热数据，结构数组）
+    struct ChannelArrays {
+        std::vector<float> cutoff, beta, slopeCutoff; // beta 在非 1-euro 时为 0
+        std::vector<float> deadzone, invRange, curve;
+        std::vector<float> radial;                    // 0 或 1
+        std::vector<uint32_t> partner;                // 无配对时为自身
+        std::vector<uint8_t> smoothed;
+        std::vector<uint64_t> lastTimestamp;          // 0 表示尚无采样
+        std::vector<float> filtered, slope;
+        std::vector<float> current;                   // 最近一次平滑后的值（径向死区读取另一轴时使用）
+    };
+
+    // 开放寻址的 (设备, 输入码) -> 通道 查找表，只在修改配置时重建
+    struct Slot {
+        uint64_t key = 0;
+        uint32_t channel = kNoChannel;
+    };
+
+    static uint64_t makeKey(DeviceType device, int code) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(device)) << 32) | static_cast<uint32_t>(code);
+    }
+
+    static size_t hashKey(uint64_t key) {
+        return static_cast<size_t>((key ^ (key >> 29)) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    uint32_t findChannel(uint64_t key) const {
+        if (slots.empty()) return kNoChannel;
+        for (size_t i = hashKey(key) & slotMask;; i = (i + 1) & slotMask) {
+            const Slot& slot = slots[i];
+            if (slot.channel == kNoChannel || slot.key == key) return slot.channel;
+        }
+    }
+
+    void rebuildIndex();
+    void rebuildArrays();
+    void smoothSamples();
+    void shapeSamples();
+
+    const AnalogKernelTable* kernels;
+    std::vector<Channel> channels;
+    ChannelArrays arrays;
+    std::vector<Slot> slots;
+    size_t slotMask = 0;
+
+    // 以下为帧间复用的临时空间（结构数组）
+    std::vector<uint32_t> sampleEvent;   // 采样对应的事件下标
+    std::vector<uint32_t> sampleChannel;
+    std::vector<uint64_t> sampleTime;
+    std::vector<float> sampleValue;
+    std::vector<uint32_t> laneStamp;     // 每个通道最近加入的批次编号
+    uint32_t batchStamp = 1;
+    std::vector<uint32_t> laneSample;    // 批次内每个位置对应的采样
+    std::vector<float> laneInput, laneDt, laneMinCutoff, laneBeta, laneSlopeCutoff, laneValue, laneSlope;
+    std::vector<float> shapePartner, shapeRadial, shapeDeadzone, shapeInvRange, shapeCurve;
+};
+
+#endif // ANALOG_CONDITIONER_H
@@ -0,0 +1,183 @@
+#include "AnalogKernels.h"
+#include <algorithm>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define INPUT_HAS_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr float kTwoPi = 6.28318530718f;
+constexpr float kMinMagnitude = 1e-12f;
+
+// ---- 标量版本：也用于 SIMD 版本的尾部 ----
+
+void shapeScalar(const ShapeBatch& b, size_t begin) {
+    for (size_t i = begin; i < b.count; ++i) {
+        const float v = b.value[i];
+        const float p = b.radial[i] * b.partner[i];
+        const float mag = std::sqrt(v * v + p * p);
+        const float t = std::min(std::max((mag - b.deadzone[i]) * b.invRange[i], 0.0f), 1.0f);
+        const float shaped = (1.0f - b.curve[i]) * t + b.curve[i] * (t * t * t);
+        b.value[i] = v * shaped / std::max(mag, kMinMagnitude);
+    }
+}
+
+inline float smoothingAlpha(float dt, float cutoff) {
+    const float r = kTwoPi * cutoff * dt;
+    return r / (1.0f + r);
+}
+
+void smoothScalar(const SmoothBatch& b, size_t begin) {
+    for (size_t i = begin; i < b.count; ++i) {
+        const float x = b.input[i];
+        const float prev = b.value[i];
+        const float rawSlope = (x - prev) / b.dt[i];
+        const float slope = b.slope[i] + smoothingAlpha(b.dt[i], b.slopeCutoff[i]) * (rawSlope - b.slope[i]);
+        const float cutoff = b.minCutoff[i] + b.beta[i] * std::fabs(slope);
+        b.value[i] = prev + smoothingAlpha(b.dt[i], cutoff) * (x - prev);
+        b.slope[i] = slope;
+    }
+}
+
+void shapeScalarAll(const ShapeBatch& b) { shapeScalar(b, 0); }
+void smoothScalarAll(const SmoothBatch& b) { smoothScalar(b, 0); }
+
+#ifdef INPUT_HAS_X86_SIMD
+
+// ---- SSE：x86-64 基线指令集，无需运行时检测 ----
+
+__attribute__((target("sse2"))) void shapeSse(const ShapeBatch& b) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 eps = _mm_set1_ps(kMinMagnitude);
+    size_t i = 0;
+    for (; i + 4 <= b.count; i += 4) {
+        const __m128 v = _mm_loadu_ps(b.value + i);
+        const __m128 p = _mm_mul_ps(_mm_loadu_ps(b.radial + i), _mm_loadu_ps(b.partner + i));
+        const __m128 mag = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(v, v), _mm_mul_ps(p, p)));
+        __m128 t = _mm_mul_ps(_mm_sub_ps(mag, _mm_loadu_ps(b.deadzone + i)), _mm_loadu_ps(b.invRange + i));
+        t = _mm_min_ps(_mm_max_ps(t, zero), one);
+        const __m128 curve = _mm_loadu_ps(b.curve + i);
+        const __m128 cubic = _mm_mul_ps(_mm_mul_ps(t, t), t);
+        const __m128 shaped = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, curve), t), _mm_mul_ps(curve, cubic));
+        _mm_storeu_ps(b.value + i, _mm_div_ps(_mm_mul_ps(v, shaped), _mm_max_ps(mag, eps)));
+    }
+    shapeScalar(b, i);
+}
+
+__attribute__((target("sse2"))) inline __m128 alphaSse(__m128 dt, __m128 cutoff) {
+    const __m128 r = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(kTwoPi), cutoff), dt);
+    return _mm_div_ps(r, _mm_add_ps(_mm_set1_ps(1.0f), r));
+}
+
+__attribute__((target("sse2"))) void smoothSse(const SmoothBatch& b) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    size_t i = 0;
+    for (; i + 4 <= b.count; i += 4) {
+        const __m128 x = _mm_loadu_ps(b.input + i);
+        const __m128 dt = _mm_loadu_ps(b.dt + i);
+        const __m128 prev = _mm_loadu_ps(b.value + i);
+        const __m128 prevSlope = _mm_loadu_ps(b.slope + i);
+        const __m128 rawSlope = _mm_div_ps(_mm_sub_ps(x, prev), dt);
+        const __m128 slope = _mm_add_ps(prevSlope, _mm_mul_ps(alphaSse(dt, _mm_loadu_ps(b.slopeCutoff + i)),
+                                                               _mm_sub_ps(rawSlope, prevSlope)));
+        const __m128 cutoff = _mm_add_ps(_mm_loadu_ps(b.minCutoff + i),
+                                         _mm_mul_ps(_mm_loadu_ps(b.beta + i), _mm_and_ps(slope, absMask)));
+        _mm_storeu_ps(b.value + i, _mm_add_ps(prev, _mm_mul_ps(alphaSse(dt, cutoff), _mm_sub_ps(x, prev))));
+        _mm_storeu_ps(b.slope + i, slope);
+    }
+    smoothScalar(b, i);
+}
+
+// ---- AVX2：运行时检测后才会调用 ----
+
+__attribute__((target("avx2"))) void shapeAvx2(const ShapeBatch& b) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 eps = _mm256_set1_ps(kMinMagnitude);
+    size_t i = 0;
+    for (; i + 8 <= b.count; i += 8) {
+        const __m256 v = _mm256_loadu_ps(b.value + i);
+        const __m256 p = _mm256_mul_ps(_mm256_loadu_ps(b.radial + i), _mm256_loadu_ps(b.partner + i));
+        const __m256 mag = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(v, v), _mm256_mul_ps(p, p)));
+        __m256 t = _mm256_mul_ps(_mm256_sub_ps(mag, _mm256_loadu_ps(b.deadzone + i)),
+                                 _mm256_loadu_ps(b.invRange + i));
+        t = _mm256_min_ps(_mm256_max_ps(t, zero), one);
+        const __m256 curve = _mm256_loadu_ps(b.curve + i);
+        const __m256 cubic = _mm256_mul_ps(_mm256_mul_ps(t, t), t);
+        const __m256 shaped = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(one, curve), t),
+                                            _mm256_mul_ps(curve, cubic));
+        _mm256_storeu_ps(b.value + i, _mm256_div_ps(_mm256_mul_ps(v, shaped), _mm256_max_ps(mag, eps)));
+    }
+    shapeScalar(b, i);
+}
+
+__attribute__((target("avx2"))) inline __m256 alphaAvx2(__m256 dt, __m256 cutoff) {
+    const __m256 r = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(kTwoPi), cutoff), dt);
+    return _mm256_div_ps(r, _mm256_add_ps(_mm256_set1_ps(1.0f), r));
+}
+
+__attribute__((target("avx2"))) void smoothAvx2(const SmoothBatch& b) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    size_t i = 0;
+    for (; i + 8 <= b.count; i += 8) {
+        const __m256 x = _mm256_loadu_ps(b.input + i);
+        const __m256 dt = _mm256_loadu_ps(b.dt + i);
+        const __m256 prev = _mm256_loadu_ps(b.value + i);
+        const __m256 prevSlope = _mm256_loadu_ps(b.slope + i);
+        const __m256 rawSlope = _mm256_div_ps(_mm256_sub_ps(x, prev), dt);
+        const __m256 slope = _mm256_add_ps(
+            prevSlope, _mm256_mul_ps(alphaAvx2(dt, _mm256_loadu_ps(b.slopeCutoff + i)),
+                                     _mm256_sub_ps(rawSlope, prevSlope)));
+        const __m256 cutoff = _mm256_add_ps(
+            _mm256_loadu_ps(b.minCutoff + i),
+            _mm256_mul_ps(_mm256_loadu_ps(b.beta + i), _mm256_and_ps(slope, absMask)));
+        _mm256_storeu_ps(b.value + i,
+                         _mm256_add_ps(prev, _mm256_mul_ps(alphaAvx2(dt, cutoff), _mm256_sub_ps(x, prev))));
+        _mm256_storeu_ps(b.slope + i, slope);
+    }
+    smoothScalar(b, i);
+}
+
+#endif // INPUT_HAS_X86_SIMD
+
+const AnalogKernelTable kScalarKernels{SimdLevel::Scalar, &shapeScalarAll, &smoothScalarAll};
+#ifdef INPUT_HAS_X86_SIMD
+const AnalogKernelTable kSseKernels{SimdLevel::SSE, &shapeSse, &smoothSse};
+const AnalogKernelTable kAvx2Kernels{SimdLevel::AVX2, &shapeAvx2, &smoothAvx2};
+#endif
+
+} // namespace
+
+namespace AnalogKernels {
+
+SimdLevel detect() {
+#ifdef INPUT_HAS_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE;
+#endif
+    return SimdLevel::Scalar;
+}
+
+const AnalogKernelTable& select(SimdLevel level) {
+#ifdef INPUT_HAS_X86_SIMD
+    static const SimdLevel supported = detect();
+    level = std::min(level, supported);
+    if (level == SimdLevel::AVX2) return kAvx2Kernels;
+    if (level == SimdLevel::SSE) return kSseKernels;
+#else
+    (void)level;
+#endif
+    return kScalarKernels;
+}
+
+const AnalogKernelTable& best() {
+    static const AnalogKernelTable& kernels = select(detect());
+    return kernels;
+}
+
+} // namespace AnalogKernels
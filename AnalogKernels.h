@@ -0,0 +1,81 @@
+#ifndef ANALOG_KERNELS_H
+#define ANALOG_KERNELS_H
+
+#include <cstddef>
+
+// 模拟量调理的批处理内核：输入为结构数组（SoA），每个数组下标对应一个轴采样。
+// 同一实现有标量、SSE、AVX2 三个版本，运行时按 CPU 支持情况选择。
+
+// 指令集级别
+enum class SimdLevel {
+    Scalar,
+    SSE,
+    AVX2
+};
+
+// 将指令集级别转换为字符串
+inline const char* simdLevelToString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar:
+            return "scalar";
+        case SimdLevel::SSE:
+            return "sse";
+        case SimdLevel::AVX2:
+            return "avx2";
+        default:
+            return "unknown";
+    }
+}
+
+// 死区与响应曲线（无状态，逐采样独立）：
+//   mag = sqrt(value^2 + (radial * partner)^2)   radial 为 0 时即 |value|（轴向死区）
+//   t   = clamp((mag - deadzone) * invRange, 0, 1)
+//   out = value * ((1 - curve) * t + curve * t^3) / mag
+// 径向死区时 partner 为同一摇杆另一轴的当前值，结果保持摇杆方向不变。
+struct ShapeBatch {
+    size_t count = 0;
+    float* value = nullptr;           // 输入输出
+    const float* partner = nullptr;
+    const float* radial = nullptr;    // 0 或 1
+    const float* deadzone = nullptr;
+    const float* invRange = nullptr;  // 1 / (outerDeadzone - deadzone)
+    const float* curve = nullptr;     // 0 线性，1 纯三次
+};
+
+// 1-euro 平滑（低通为 beta = 0 的特例）。每个下标是一个独立的通道，
+// 同一通道的相邻采样必须分批依次处理。
+//   slope  = lerp(slope, (input - value) / dt, alpha(dt, slopeCutoff))
+//   cutoff = minCutoff + beta * |slope|
+//   value  = lerp(value, input, alpha(dt, cutoff))
+//   alpha(dt, fc) = r / (1 + r)，r = 2π·fc·dt
+struct SmoothBatch {
+    size_t count = 0;
+    const float* input = nullptr;
+    const float* dt = nullptr;          // 秒，必须大于 0
+    const float* minCutoff = nullptr;   // Hz
+    const float* beta = nullptr;
+    const float* slopeCutoff = nullptr; // Hz
+    float* value = nullptr;             // 输入：上一次的平滑值；输出：本次平滑值
+    float* slope = nullptr;             // 输入输出：平滑后的变化率
+};
+
+struct AnalogKernelTable {
+    SimdLevel level;
+    void (*shape)(const ShapeBatch& batch);
+    void (*smooth)(const SmoothBatch& batch);
+};
+
+namespace AnalogKernels {
+
+// 当前 CPU 支持的最高级别
+SimdLevel detect();
+
+// 指定级别的内核；不支持时降级到可用的最高级别
+const AnalogKernelTable& select(SimdLevel level);
+
+// 当前 CPU 上最快的内核（首次调用时检测）
+const AnalogKernelTable& best();
+
+} // namespace AnalogKernels
+
+#endif // ANALOG_KERNELS_H
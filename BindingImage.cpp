@@ -0,0 +1,269 @@
+#include "BindingTable.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <filesystem>
+#include <ostream>
+
+// 预编译绑定文件格式（小端，由 bindc 根据 bindings.json 生成）：
+//   Header（80 字节）
+//   Slot[slotCount]          开放寻址哈希表，布局与 BindingTable::Slot 相同
+//   ActionId[idCount]        所有绑定的动作编号
+//   uint32[actionCount + 1]  动作名在名称区中的起止偏移
+//   char[namesSize]          动作名（不含结尾 0）
+//   ComboRecord[comboCount]  连招定义
+//   ActionId[comboStepCount] 连招步骤
+// 各区段按 8 字节对齐，加载时直接在映射内存上使用槽位与编号，不解析、不重建。
+// 加载的代价与文件大小成线性：槽位与编号要做越界检查（文件可能损坏），动作名复制为
+// std::string 并建立名称索引，连招定义重新编译为自动机。
+namespace {
+
+constexpr char kImageMagic[4] = {'K', 'S', 'B', 'T'};
+constexpr uint16_t kImageVersion = 2;
+
+struct ImageHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t slotCount;     // 2 的幂；为 0 表示空表
+    uint32_t idCount;
+    uint32_t actionCount;
+    uint32_t namesSize;
+    uint64_t sourceSize;    // 源 JSON 的大小
+    int64_t sourceMtime;    // 源 JSON 的修改时间（file_time_type 计数）
+    uint32_t slotsOffset;
+    uint32_t idsOffset;
+    uint32_t nameOffsetsOffset;
+    uint32_t namesOffset;
+    uint32_t comboCount;
+    uint32_t comboStepCount;
+    uint32_t combosOffset;
+    uint32_t comboStepsOffset;
+    uint32_t reserved[2];
+};
+static_assert(sizeof(ImageHeader) == 80, "binding image header must stay 80 bytes");
+
+struct ComboRecord {
+    uint64_t windowNanos;
+    uint32_t stepOffset;
+    uint32_t stepCount;
+    uint16_t action;
+    uint8_t kind;
+    uint8_t reserved[5];
+};
+static_assert(sizeof(ComboRecord) == 24, "combo record must stay 24 bytes");
+
+size_t alignUp(size_t value) { return (value + 7) & ~size_t{7}; }
+
+void writePadding(std::ostream& out, size_t& written) {
+    static const char zeros[8] = {};
+    size_t aligned = alignUp(written);
+    out.write(zeros, static_cast<std::streamsize>(aligned - written));
+    written = aligned;
+}
+
+} // namespace
+
+bool BindingSourceStamp::of(const std::string& path, BindingSourceStamp& out) {
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    out.size = static_cast<uint64_t>(size);
+    out.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    return true;
+}
+
+bool BindingTable::writeImage(std::ostream& out, const BindingSourceStamp& stamp) const {
+    const size_t slotCount = slotData ? slotMask + 1 : 0;
+
+    ImageHeader header{};
+    std::memcpy(header.magic, kImageMagic, sizeof(kImageMagic));
+    header.version = kImageVersion;
+    header.headerSize = sizeof(ImageHeader);
+    header.slotCount = static_cast<uint32_t>(slotCount);
+    header.idCount = static_cast<uint32_t>(idCount);
+    header.actionCount = static_cast<uint32_t>(actions.size());
+    header.sourceSize = stamp.size;
+    header.sourceMtime = stamp.mtime;
+
+    std::vector<uint32_t> nameOffsets;
+    nameOffsets.reserve(actions.size() + 1);
+    uint32_t namesSize = 0;
+    for (const GameAction& action : actions) {
+        nameOffsets.push_back(namesSize);
+        namesSize += static_cast<uint32_t>(action.name.size());
+    }
+    nameOffsets.push_back(namesSize);
+    header.namesSize = namesSize;
+
+    size_t offset = sizeof(ImageHeader);
+    header.slotsOffset = static_cast<uint32_t>(offset);
+    offset = alignUp(offset + slotCount * sizeof(Slot));
+    header.idsOffset = static_cast<uint32_t>(offset);
+    offset = alignUp(offset + idCount * sizeof(ActionId));
+    header.nameOffsetsOffset = static_cast<uint32_t>(offset);
+    offset = alignUp(offset + nameOffsets.size() * sizeof(uint32_t));
+    header.namesOffset = static_cast<uint32_t>(offset);
+    offset = alignUp(offset + namesSize);
+
+    std::vector<ComboRecord> comboRecords;
+    std::vector<ActionId> comboSteps;
+    for (const ComboDefinition& combo : comboAutomaton.combos()) {
+        ComboRecord record{};
+        record.windowNanos = combo.windowNanos;
+        record.stepOffset = static_cast<uint32_t>(comboSteps.size());
+        record.stepCount = static_cast<uint32_t>(combo.steps.size());
+        record.action = combo.action;
+        record.kind = static_cast<uint8_t>(combo.kind);
+        comboRecords.push_back(record);
+        comboSteps.insert(comboSteps.end(), combo.steps.begin(), combo.steps.end());
+    }
+    header.comboCount = static_cast<uint32_t>(comboRecords.size());
+    header.comboStepCount = static_cast<uint32_t>(comboSteps.size());
+    header.combosOffset = static_cast<uint32_t>(offset);
+    offset = alignUp(offset + comboRecords.size() * sizeof(ComboRecord));
+    header.comboStepsOffset = static_cast<uint32_t>(offset);
+
+    size_t written = 0;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    written += sizeof(header);
+    out.write(reinterpret_cast<const char*>(slotData), static_cast<std::streamsize>(slotCount * sizeof(Slot)));
+    written += slotCount * sizeof(Slot);
+    writePadding(out, written);
+    out.write(reinterpret_cast<const char*>(idData), static_cast<std::streamsize>(idCount * sizeof(ActionId)));
+    written += idCount * sizeof(ActionId);
+    writePadding(out, written);
+    out.write(reinterpret_cast<const char*>(nameOffsets.data()),
+              static_cast<std::streamsize>(nameOffsets.size() * sizeof(uint32_t)));
+    written += nameOffsets.size() * sizeof(uint32_t);
+    writePadding(out, written);
+    for (const GameAction& action : actions) {
+        out.write(action.name.data(), static_cast<std::streamsize>(action.name.size()));
+    }
+    written += namesSize;
+    writePadding(out, written);
+    out.write(reinterpret_cast<const char*>(comboRecords.data()),
+              static_cast<std::streamsize>(comboRecords.size() * sizeof(ComboRecord)));
+    written += comboRecords.size() * sizeof(ComboRecord);
+    writePadding(out, written);
+    out.write(reinterpret_cast<const char*>(comboSteps.data()),
+              static_cast<std::streamsize>(comboSteps.size() * sizeof(ActionId)));
+    return static_cast<bool>(out);
+}
+
+std::shared_ptr<const BindingTable> BindingTable::fromImage(std::shared_ptr<const MappedFile> file,
+                                                            std::string& error,
+                                                            BindingSourceStamp* stamp) {
+    if (!file || file->size() < sizeof(ImageHeader)) {
+        error = "file too small";
+        return nullptr;
+    }
+    const unsigned char* base = file->data();
+    const size_t size = file->size();
+
+    ImageHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kImageMagic, sizeof(kImageMagic)) != 0) {
+        error = "bad magic";
+        return nullptr;
+    }
+    if (header.version != kImageVersion || header.headerSize != sizeof(ImageHeader)) {
+        error = "unsupported version";
+        return nullptr;
+    }
+
+    const size_t slotCount = header.slotCount;
+    auto sectionFits = [size](size_t offset, size_t bytes, size_t alignment) {
+        return offset % alignment == 0 && offset <= size && bytes <= size - offset;
+    };
+    if ((slotCount & (slotCount - 1)) != 0 ||
+        !sectionFits(header.slotsOffset, slotCount * sizeof(Slot), alignof(Slot)) ||
+        !sectionFits(header.idsOffset, size_t{header.idCount} * sizeof(ActionId), alignof(ActionId)) ||
+        !sectionFits(header.nameOffsetsOffset, (size_t{header.actionCount} + 1) * sizeof(uint32_t),
+                     alignof(uint32_t)) ||
+        !sectionFits(header.namesOffset, header.namesSize, 1) ||
+        !sectionFits(header.combosOffset, size_t{header.comboCount} * sizeof(ComboRecord), alignof(ComboRecord)) ||
+        !sectionFits(header.comboStepsOffset, size_t{header.comboStepCount} * sizeof(ActionId), alignof(ActionId)) ||
+        header.actionCount >= kInvalidActionId) {
+        error = "corrupt section table";
+        return nullptr;
+    }
+
+    const Slot* slots = reinterpret_cast<const Slot*>(base + header.slotsOffset);
+    const ActionId* ids = reinterpret_cast<const ActionId*>(base + header.idsOffset);
+    const uint32_t* nameOffsets = reinterpret_cast<const uint32_t*>(base + header.nameOffsetsOffset);
+    const char* names = reinterpret_cast<const char*>(base + header.namesOffset);
+
+    // 只做越界检查，保证损坏的文件不会让查询越界或死循环；不重建任何结构
+    size_t usedSlots = 0;
+    for (size_t i = 0; i < slotCount; ++i) {
+        const Slot& slot = slots[i];
+        if (slot.key == 0) continue;
+        ++usedSlots;
+        if (slot.offset > header.idCount || slot.count > header.idCount - slot.offset) {
+            error = "corrupt slot";
+            return nullptr;
+        }
+    }
+    if (slotCount > 0 && usedSlots == slotCount) {
+        error = "slot table has no empty slot";
+        return nullptr;
+    }
+    for (size_t i = 0; i < header.idCount; ++i) {
+        if (ids[i] >= header.actionCount) {
+            error = "action id out of range";
+            return nullptr;
+        }
+    }
+
+    auto table = std::make_shared<BindingTable>();
+    table->actions.reserve(header.actionCount);
+    for (uint32_t i = 0; i < header.actionCount; ++i) {
+        uint32_t begin = nameOffsets[i];
+        uint32_t end = nameOffsets[i + 1];
+        if (begin > end || end > header.namesSize) {
+            error = "corrupt action name table";
+            return nullptr;
+        }
+        table->actions.push_back(GameAction{std::string(names + begin, end - begin)});
+        table->actionIds.emplace(table->actions.back().name, static_cast<ActionId>(i));
+    }
+
+    const ComboRecord* comboRecords = reinterpret_cast<const ComboRecord*>(base + header.combosOffset);
+    const ActionId* comboSteps = reinterpret_cast<const ActionId*>(base + header.comboStepsOffset);
+    std::vector<ComboDefinition> combos(header.comboCount);
+    for (uint32_t i = 0; i < header.comboCount; ++i) {
+        const ComboRecord& record = comboRecords[i];
+        if (record.stepOffset > header.comboStepCount || record.stepCount > header.comboStepCount - record.stepOffset ||
+            record.action >= header.actionCount || record.kind > static_cast<uint8_t>(ComboKind::Chord)) {
+            error = "corrupt combo table";
+            return nullptr;
+        }
+        combos[i].action = record.action;
+        combos[i].kind = static_cast<ComboKind>(record.kind);
+        combos[i].windowNanos = record.windowNanos;
+        combos[i].steps.assign(comboSteps + record.stepOffset, comboSteps + record.stepOffset + record.stepCount);
+        for (ActionId step : combos[i].steps) {
+            if (step >= header.actionCount) {
+                error = "corrupt combo table";
+                return nullptr;
+            }
+        }
+    }
+    table->comboAutomaton.compile(std::move(combos), header.actionCount);
+
+    if (slotCount > 0) {
+        table->slotData = slots;
+        table->slotMask = slotCount - 1;
+    }
+    table->idData = ids;
+    table->idCount = header.idCount;
+    table->image = std::move(file);
+
+    if (stamp) {
+        stamp->size = header.sourceSize;
+        stamp->mtime = header.sourceMtime;
+    }
+    return table;
+}
@@ -0,0 +1,89 @@
+#include "BindingTable.h"
+#include <stdexcept>
+
+BindingTable::Builder::Builder(const BindingTable& base) {
+    internActionsOf(base);
+    base.forEachBinding([&](DeviceType device, int code, ActionIdSpan ids) {
+        for (ActionId id : ids) addBinding(device, code, id);
+    });
+    pendingCombos = base.comboAutomaton.combos();
+}
+
+void BindingTable::Builder::internActionsOf(const BindingTable& base) {
+    for (const GameAction& action : base.actions) {
+        internAction(action.name);
+    }
+}
+
+bool BindingTable::preservesActionIds(const BindingTable& base) const {
+    if (actions.size() < base.actions.size()) return false;
+    for (size_t i = 0; i < base.actions.size(); ++i) {
+        if (actions[i].name != base.actions[i].name) return false;
+    }
+    return true;
+}
+
+ActionId BindingTable::Builder::internAction(const std::string& name) {
+    auto it = table.actionIds.find(name);
+    if (it != table.actionIds.end()) {
+        return it->second;
+    }
+    if (table.actions.size() >= kInvalidActionId) {
+        throw std::length_error("BindingTable: too many actions");
+    }
+    ActionId id = static_cast<ActionId>(table.actions.size());
+    table.actions.push_back(GameAction{name});
+    table.actionIds.emplace(name, id);
+    return id;
+}
+
+void BindingTable::Builder::addBinding(DeviceType device, int code, ActionId action) {
+    const uint64_t key = makeKey(device, code);
+    auto it = pendingIndex.find(key);
+    if (it == pendingIndex.end()) {
+        it = pendingIndex.emplace(key, pending.size()).first;
+        pending.emplace_back(key, std::vector<ActionId>{});
+    }
+    pending[it->second].second.push_back(action);
+}
+
+void BindingTable::Builder::clearBinding(DeviceType device, int code) {
+    auto it = pendingIndex.find(makeKey(device, code));
+    if (it != pendingIndex.end()) {
+        pending[it->second].second.clear();
+    }
+}
+
+BindingTable BindingTable::Builder::build() {
+    // 负载因子不超过 0.5，保证探测链很短
+    size_t capacity = 8;
+    while (capacity < pending.size() * 2) capacity <<= 1;
+
+    table.slots.assign(capacity, Slot{});
+    table.slotMask = capacity - 1;
+    table.idPool.clear();
+
+    for (const auto& [key, ids] : pending) {
+        if (ids.empty()) continue;
+        size_t i = hashKey(key) & table.slotMask;
+        while (table.slots[i].key != 0) i = (i + 1) & table.slotMask;
+        Slot& slot = table.slots[i];
+        slot.key = key;
+        slot.offset = static_cast<uint32_t>(table.idPool.size());
+        slot.count = static_cast<uint32_t>(ids.size());
+        table.idPool.insert(table.idPool.end(), ids.begin(), ids.end());
+    }
+
+    table.comboAutomaton.compile(std::move(pendingCombos), table.actions.size());
+    pendingCombos.clear();
+
+    table.slotData = table.slots.data();
+    table.idData = table.idPool.data();
+    table.idCount = table.idPool.size();
+
+    pending.clear();
+    pendingIndex.clear();
+    BindingTable result = std::move(table);
+    table = BindingTable{};
+    return result;
+}
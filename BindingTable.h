@@ -0,0 +1,199 @@
+#ifndef BINDING_TABLE_H
+#define BINDING_TABLE_H
+
+#include "ComboAutomaton.h"
+#include "DeviceEvent.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 稠密的动作编号，加载时由动作名驻留（intern）得到
+using ActionId = uint16_t;
+constexpr ActionId kInvalidActionId = 0xFFFF;
+
+// 代表一个逻辑动作，例如 "Attack", "Jump"
+struct GameAction {
+    std::string name;
+    // 可以添加其他与动作相关的属性，如是否是持续性动作等
+};
+
+// 非拥有的动作编号视图（C++17 下 std::span 的简化替代）
+struct ActionIdSpan {
+    const ActionId* ptr = nullptr;
+    size_t count = 0;
+
+    const ActionId* begin() const { return ptr; }
+    const ActionId* end() const { return ptr + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    ActionId operator[](size_t i) const { return ptr[i]; }
+};
+
+class MappedFile;
+
+// 预编译绑定文件的来源标记：源 JSON 的大小与修改时间，用于判断缓存是否过期
+struct BindingSourceStamp {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+
+    bool operator==(const BindingSourceStamp& other) const {
+        return size == other.size && mtime == other.mtime;
+    }
+    bool operator!=(const BindingSourceStamp& other) const { return !(*this == other); }
+
+    // 读取文件的来源标记，文件不存在时返回 false
+    static bool of(const std::string& path, BindingSourceStamp& out);
+};
+
+// 扁平的绑定表：(DeviceType, code) -> 动作编号列表
+// 使用开放寻址（线性探测）哈希，所有动作编号存放在同一块连续内存中，
+// 查询不分配内存，也不涉及字符串比较。构建完成后只读。
+//
+// 槽位与动作编号既可以由 Builder 构建在自有内存中，也可以直接指向内存映射的
+// 预编译绑定文件（见 writeImage / fromImage），后者加载时无需解析和重建哈希表。
+class BindingTable {
+public:
+    class Builder;
+
+    BindingTable() = default;
+    // 移动时 vector 的缓冲区随之转移，slotData / idData 仍然有效；禁止拷贝
+    BindingTable(BindingTable&&) = default;
+    BindingTable& operator=(BindingTable&&) = default;
+    BindingTable(const BindingTable&) = delete;
+    BindingTable& operator=(const BindingTable&) = delete;
+
+    // 查询某个输入绑定的所有动作；返回的视图在表的生命周期内有效
+    ActionIdSpan lookup(DeviceType device, int code) const {
+        if (!slotData) return {};
+        const uint64_t key = makeKey(device, code);
+        for (size_t i = hashKey(key) & slotMask;; i = (i + 1) & slotMask) {
+            const Slot& slot = slotData[i];
+            if (slot.key == key) return {idData + slot.offset, slot.count};
+            if (slot.key == 0) return {};
+        }
+    }
+
+    const GameAction& action(ActionId id) const { return actions[id]; }
+    size_t actionCount() const { return actions.size(); }
+
+    // 按名称查找动作编号（加载期使用），不存在时返回 kInvalidActionId
+    ActionId findAction(const std::string& name) const {
+        auto it = actionIds.find(name);
+        return it != actionIds.end() ? it->second : kInvalidActionId;
+    }
+
+    // 逐个遍历所有绑定（用于调试输出等非热路径）
+    template <typename Fn>
+    void forEachBinding(Fn&& fn) const {
+        if (!slotData) return;
+        for (size_t i = 0; i <= slotMask; ++i) {
+            const Slot& slot = slotData[i];
+            if (slot.key == 0) continue;
+            fn(static_cast<DeviceType>((slot.key >> 32) - 1),
+               static_cast<int>(static_cast<uint32_t>(slot.key)),
+               ActionIdSpan{idData + slot.offset, slot.count});
+        }
+    }
+
+    // 连招自动机（连招名已作为动作驻留，识别成功时发出对应的动作编号）
+    const ComboAutomaton& combos() const { return comboAutomaton; }
+
+    // 本表是否保留了 base 的全部动作编号（同一编号对应同一动作名），
+    // 即按 ActionId 保存的状态在切换到本表后仍指向同一动作
+    bool preservesActionIds(const BindingTable& base) const;
+
+    // 是否直接使用内存映射的预编译文件
+    bool isMapped() const { return image != nullptr; }
+
+    // 写出预编译绑定文件（格式见 BindingImage.cpp），stamp 记录源 JSON 的状态
+    bool writeImage(std::ostream& out, const BindingSourceStamp& stamp) const;
+
+    // 在映射好的预编译文件上直接构造绑定表：槽位与动作编号原地使用，不解析 JSON、
+    // 不重建哈希表。加载仍是线性的：逐个检查槽位与动作编号是否越界，复制动作名并
+    // 建立名称索引，重新编译连招自动机；省掉的是 JSON 解析与逐条插入绑定。
+    // 文件损坏或版本不符时返回 nullptr 并填写 error。
+    // 若 stamp 非空，则写入文件记录的源 JSON 状态。
+    static std::shared_ptr<const BindingTable> fromImage(std::shared_ptr<const MappedFile> file,
+                                                         std::string& error,
+                                                         BindingSourceStamp* stamp = nullptr);
+
+private:
+    // 布局即预编译文件中的槽位布局，修改时需提升文件版本号
+    struct Slot {
+        uint64_t key = 0;     // 0 表示空槽
+        uint32_t offset = 0;  // 在动作编号池中的起始位置
+        uint32_t count = 0;
+    };
+    static_assert(sizeof(Slot) == 16, "binding slot layout is part of the image format");
+
+    static uint64_t makeKey(DeviceType device, int code) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(device) + 1) << 32) |
+               static_cast<uint32_t>(code);
+    }
+
+    static size_t hashKey(uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return static_cast<size_t>(key);
+    }
+
+    // 查询使用的视图：指向 slots/idPool，或指向映射文件中的对应区段
+    const Slot* slotData = nullptr;
+    size_t slotMask = 0;
+    const ActionId* idData = nullptr;
+    size_t idCount = 0;
+
+    std::vector<Slot> slots;                   // Builder 构建时的自有存储
+    std::vector<ActionId> idPool;
+    std::shared_ptr<const MappedFile> image;   // 映射模式下保持文件存活
+
+    std::vector<GameAction> actions;
+    std::unordered_map<std::string, ActionId> actionIds;
+    ComboAutomaton comboAutomaton;
+};
+
+// 绑定表构建器：加载配置时使用，build() 后生成只读的 BindingTable
+class BindingTable::Builder {
+public:
+    Builder() = default;
+    // 以已有的表为基础（保留全部动作编号与绑定），用于运行时改键
+    explicit Builder(const BindingTable& base);
+
+    // 驻留动作名，重复调用返回同一编号
+    ActionId internAction(const std::string& name);
+
+    // 按 base 的编号顺序驻留它的全部动作名，之后驻留的新动作排在其后。
+    // 热重载以当前表为种子，使同名动作保持原编号（须在驻留其他动作之前调用）
+    void internActionsOf(const BindingTable& base);
+
+    // 按名称查找已驻留的动作
+    ActionId findAction(const std::string& name) const {
+        auto it = table.actionIds.find(name);
+        return it != table.actionIds.end() ? it->second : kInvalidActionId;
+    }
+
+    // 添加一条绑定，同一输入上的动作按添加顺序保存
+    void addBinding(DeviceType device, int code, ActionId action);
+
+    // 清除某个输入上的全部绑定
+    void clearBinding(DeviceType device, int code);
+
+    // 添加连招；combo.action 与 steps 须为已驻留的动作
+    void addCombo(ComboDefinition combo) { pendingCombos.push_back(std::move(combo)); }
+
+    BindingTable build();
+
+private:
+    BindingTable table;
+    std::vector<std::pair<uint64_t, std::vector<ActionId>>> pending;
+    std::unordered_map<uint64_t, size_t> pendingIndex;
+    std::vector<ComboDefinition> pendingCombos;
+};
+
+#endif // BINDING_TABLE_H
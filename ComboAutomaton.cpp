@@ -0,0 +1,149 @@
+#include "ComboAutomaton.h"
+#include <algorithm>
+#include <atomic>
+#include <queue>
+
+namespace {
+std::atomic<uint64_t> gNextCompileId{1};
+} // namespace
+
+void ComboAutomaton::compile(std::vector<ComboDefinition> combos, size_t actionCount) {
+    *this = ComboAutomaton{};
+    compileId = gNextCompileId.fetch_add(1, std::memory_order_relaxed);
+
+    // 拒绝超出运行时状态容量的连招（同时按下类的成员先去重再计数）
+    size_t chordSlots = 0;
+    for (ComboDefinition& combo : combos) {
+        if (combo.kind == ComboKind::Chord) {
+            std::sort(combo.steps.begin(), combo.steps.end());
+            combo.steps.erase(std::unique(combo.steps.begin(), combo.steps.end()), combo.steps.end());
+            if (chordSlots + combo.steps.size() > kMaxChordSlots) continue;
+            chordSlots += combo.steps.size();
+        } else if (combo.steps.size() > kMaxSequenceSteps) {
+            continue;
+        }
+        definitions.push_back(std::move(combo));
+    }
+
+    // ---- 序列连招：构建 trie，再用 BFS 计算失败转移并展开为 DFA ----
+    symbolOf.assign(actionCount, kNoSymbol);
+    for (const ComboDefinition& combo : definitions) {
+        if (combo.kind != ComboKind::Sequence) continue;
+        for (ActionId step : combo.steps) {
+            if (step < actionCount && symbolOf[step] == kNoSymbol) {
+                symbolOf[step] = static_cast<uint16_t>(symbolCount++);
+            }
+        }
+        maxDepth = std::max(maxDepth, combo.steps.size());
+    }
+
+    if (symbolCount > 0) {
+        const uint32_t kNone = UINT32_MAX;
+        std::vector<uint32_t> trie(symbolCount, kNone); // 只含 trie 边
+        std::vector<std::vector<uint32_t>> ends(1);     // 每个状态上结束的连招
+        for (uint32_t c = 0; c < definitions.size(); ++c) {
+            const ComboDefinition& combo = definitions[c];
+            if (combo.kind != ComboKind::Sequence || combo.steps.empty()) continue;
+            uint32_t node = 0;
+            for (ActionId step : combo.steps) {
+                uint32_t& next = trie[node * symbolCount + symbolOf[step]];
+                if (next == kNone) {
+                    next = static_cast<uint32_t>(ends.size());
+                    ends.emplace_back();
+                    trie.resize(trie.size() + symbolCount, kNone);
+                }
+                node = trie[node * symbolCount + symbolOf[step]];
+            }
+            ends[node].push_back(c);
+        }
+
+        const size_t stateCount = ends.size();
+        transitions.assign(stateCount * symbolCount, 0);
+        std::vector<uint32_t> fail(stateCount, 0);
+        std::vector<std::vector<uint32_t>> matched(stateCount);
+        std::queue<uint32_t> pending;
+
+        for (size_t s = 0; s < symbolCount; ++s) {
+            uint32_t child = trie[s];
+            if (child != kNone) {
+                transitions[s] = child;
+                pending.push(child);
+            }
+        }
+        matched[0] = ends[0];
+        while (!pending.empty()) {
+            uint32_t node = pending.front();
+            pending.pop();
+            // 输出：自身结束的连招优先（更长），再接上失败链上的
+            matched[node] = ends[node];
+            matched[node].insert(matched[node].end(), matched[fail[node]].begin(), matched[fail[node]].end());
+            for (size_t s = 0; s < symbolCount; ++s) {
+                uint32_t child = trie[node * symbolCount + s];
+                if (child != kNone) {
+                    fail[child] = transitions[fail[node] * symbolCount + s];
+                    transitions[node * symbolCount + s] = child;
+                    pending.push(child);
+                } else {
+                    transitions[node * symbolCount + s] = transitions[fail[node] * symbolCount + s];
+                }
+            }
+        }
+
+        outputs.resize(stateCount);
+        for (size_t s = 0; s < stateCount; ++s) {
+            outputs[s].offset = static_cast<uint32_t>(outputCombos.size());
+            outputs[s].count = static_cast<uint32_t>(matched[s].size());
+            outputCombos.insert(outputCombos.end(), matched[s].begin(), matched[s].end());
+        }
+    }
+
+    // ---- 同时按下类连招：按成员动作建立倒排表 ----
+    std::vector<std::vector<ChordRef>> refsByAction(actionCount);
+    chordSlotBase.assign(definitions.size(), 0);
+    for (uint32_t c = 0; c < definitions.size(); ++c) {
+        ComboDefinition& combo = definitions[c];
+        if (combo.kind != ComboKind::Chord) continue;
+        chordSlotBase[c] = static_cast<uint32_t>(chordSlotCount);
+        for (size_t m = 0; m < combo.steps.size(); ++m) {
+            if (combo.steps[m] < actionCount) {
+                refsByAction[combo.steps[m]].push_back(ChordRef{c, static_cast<uint32_t>(chordSlotCount + m)});
+            }
+        }
+        chordSlotCount += combo.steps.size();
+    }
+    if (chordSlotCount > 0) {
+        chordsByAction.resize(actionCount);
+        for (size_t a = 0; a < actionCount; ++a) {
+            chordsByAction[a].offset = static_cast<uint32_t>(chordRefs.size());
+            chordsByAction[a].count = static_cast<uint32_t>(refsByAction[a].size());
+            chordRefs.insert(chordRefs.end(), refsByAction[a].begin(), refsByAction[a].end());
+        }
+    }
+}
+
+void ComboMatcher::attach(const ComboAutomaton& automaton) {
+    automatonId = automaton.id();
+    state = 0;
+    fed = 0;
+    history.assign(std::max<size_t>(1, automaton.maxDepth), 0);
+    chordPress.assign(automaton.chordSlotCount, 0);
+}
+
+void ComboMatcher::save(ComboMatcherState& out) const {
+    // 编译时已保证 history 不超过 kMaxSequenceSteps、chordPress 不超过 kMaxChordSlots
+    out.automatonId = automatonId;
+    out.fed = fed;
+    out.state = state;
+    out.historySize = static_cast<uint16_t>(history.size());
+    out.chordSlotCount = static_cast<uint16_t>(chordPress.size());
+    std::copy(history.begin(), history.end(), out.history);
+    std::copy(chordPress.begin(), chordPress.end(), out.chordPress);
+}
+
+void ComboMatcher::restore(const ComboMatcherState& saved) {
+    automatonId = saved.automatonId;
+    fed = saved.fed;
+    state = saved.state;
+    history.assign(saved.history, saved.history + saved.historySize);
+    chordPress.assign(saved.chordPress, saved.chordPress + saved.chordSlotCount);
+}
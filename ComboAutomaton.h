@@ -0,0 +1,175 @@
+#ifndef COMBO_AUTOMATON_H
+#define COMBO_AUTOMATON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 与 BindingTable.h 中的定义一致（避免循环包含）
+using ActionId = uint16_t;
+
+// 连招种类
+enum class ComboKind : uint8_t {
+    Sequence, // 按顺序依次触发，首尾间隔不超过时间窗，例如 下、前、攻击
+    Chord     // 同时按下：所有成员在时间窗内都被触发，顺序不限
+};
+
+// 连招定义：steps 为组成连招的动作，action 为识别成功后发出的合成动作
+struct ComboDefinition {
+    ActionId action = 0;
+    ComboKind kind = ComboKind::Sequence;
+    uint64_t windowNanos = 0;
+    std::vector<ActionId> steps;
+};
+
+// 所有连招编译成的自动机（只读，随绑定表一起共享）。
+//
+// 序列连招构成 Aho-Corasick 自动机，失败转移预先展开为稠密的 DFA 转移表，
+// 每个输入动作只做一次查表；匹配的起始时间从最近 maxDepth 个输入的时间戳环中
+// 直接取出，因此时间窗检查也是 O(1)。同时按下类连招按成员动作建立倒排表，
+// 每次只检查包含该动作的连招。连招步骤是动作而不是物理按键，跨设备的组合天然成立。
+class ComboAutomaton {
+public:
+    static constexpr uint16_t kNoSymbol = 0xFFFF;
+
+    // 运行时状态的容量上限：匹配器状态要能完整放进定长的 ComboMatcherState（回滚快照），
+    // 超出的连招在编译时被拒绝，不会出现回滚后丢失进行中连招的情况
+    static constexpr size_t kMaxSequenceSteps = 16; // 单个序列连招的最大步数
+    static constexpr size_t kMaxChordSlots = 64;    // 所有同时按下类连招的成员总数
+
+    // 编译连招定义；actionCount 为绑定表中的动作总数。
+    // 超过上述容量的连招被丢弃，不出现在 combos() 中（调用方可据此报告）
+    void compile(std::vector<ComboDefinition> combos, size_t actionCount);
+
+    bool empty() const { return definitions.empty(); }
+    const std::vector<ComboDefinition>& combos() const { return definitions; }
+
+    // 每次编译得到不同的编号，运行时状态据此判断自动机是否已更换
+    uint64_t id() const { return compileId; }
+
+private:
+    friend class ComboMatcher;
+
+    struct OutputRange {
+        uint32_t offset = 0;
+        uint32_t count = 0;
+    };
+    struct ChordRef {
+        uint32_t combo;  // definitions 下标
+        uint32_t slot;   // 该成员在 ComboMatcher::chordPress 中的位置
+    };
+
+    std::vector<ComboDefinition> definitions;
+    uint64_t compileId = 0;
+
+    // 序列连招
+    std::vector<uint16_t> symbolOf;        // ActionId -> 字母表下标
+    size_t symbolCount = 0;
+    std::vector<uint32_t> transitions;     // state * symbolCount + symbol -> state
+    std::vector<OutputRange> outputs;      // 每个状态上完成的连招（含后缀链上的）
+    std::vector<uint32_t> outputCombos;
+    size_t maxDepth = 0;
+
+    // 同时按下类连招
+    std::vector<OutputRange> chordsByAction; // ActionId -> chordRefs 区间
+    std::vector<ChordRef> chordRefs;
+    std::vector<uint32_t> chordSlotBase;     // 每个连招成员槽位的起始位置
+    size_t chordSlotCount = 0;
+};
+
+// ComboMatcher 运行时状态的定长 POD 副本（用于回滚）。容量取自 ComboAutomaton 的
+// 编译上限，任何能编译的连招集合的状态都能完整保存，恢复后的匹配与原先完全一致
+struct ComboMatcherState {
+    static constexpr size_t kMaxHistory = ComboAutomaton::kMaxSequenceSteps;
+    static constexpr size_t kMaxChordSlots = ComboAutomaton::kMaxChordSlots;
+
+    uint64_t automatonId = 0;
+    uint64_t fed = 0;
+    uint32_t state = 0;
+    uint16_t historySize = 0;
+    uint16_t chordSlotCount = 0;
+    uint64_t history[kMaxHistory] = {};
+    uint64_t chordPress[kMaxChordSlots] = {};
+};
+
+// 一个玩家的连招识别状态：当前自动机状态、最近输入的时间戳与同时按下的成员时间。
+// 自动机更换（绑定表热重载）后自动重置。
+class ComboMatcher {
+public:
+    void reset() {
+        state = 0;
+        fed = 0;
+        automatonId = 0;
+    }
+
+    void save(ComboMatcherState& out) const;
+    void restore(const ComboMatcherState& saved);
+
+    // 输入一个按下类动作；识别出连招时调用 emit(comboAction, timestamp)
+    template <typename Emit>
+    void feed(const ComboAutomaton& automaton, ActionId action, uint64_t timestamp, Emit&& emit) {
+        if (automaton.empty()) return;
+        if (automatonId != automaton.id()) attach(automaton);
+
+        feedSequence(automaton, action, timestamp, emit);
+        feedChord(automaton, action, timestamp, emit);
+    }
+
+private:
+    void attach(const ComboAutomaton& automaton);
+
+    template <typename Emit>
+    void feedSequence(const ComboAutomaton& automaton, ActionId action, uint64_t timestamp, Emit& emit) {
+        if (automaton.symbolCount == 0) return;
+        const uint16_t symbol = action < automaton.symbolOf.size() ? automaton.symbolOf[action]
+                                                                   : ComboAutomaton::kNoSymbol;
+        if (symbol == ComboAutomaton::kNoSymbol) {
+            state = 0; // 无关动作打断所有进行中的序列
+            return;
+        }
+        state = automaton.transitions[state * automaton.symbolCount + symbol];
+        history[fed % history.size()] = timestamp;
+        ++fed;
+
+        const ComboAutomaton::OutputRange& out = automaton.outputs[state];
+        for (uint32_t i = 0; i < out.count; ++i) {
+            const ComboDefinition& combo = automaton.definitions[automaton.outputCombos[out.offset + i]];
+            const uint64_t start = history[(fed - combo.steps.size()) % history.size()];
+            if (timestamp - start <= combo.windowNanos) {
+                emit(combo.action, timestamp);
+                state = 0; // 已消耗的输入不再参与后续匹配
+                return;
+            }
+        }
+    }
+
+    template <typename Emit>
+    void feedChord(const ComboAutomaton& automaton, ActionId action, uint64_t timestamp, Emit& emit) {
+        if (action >= automaton.chordsByAction.size()) return;
+        const ComboAutomaton::OutputRange& refs = automaton.chordsByAction[action];
+        for (uint32_t i = 0; i < refs.count; ++i) {
+            const ComboAutomaton::ChordRef& ref = automaton.chordRefs[refs.offset + i];
+            chordPress[ref.slot] = timestamp;
+
+            const ComboDefinition& combo = automaton.definitions[ref.combo];
+            const uint32_t base = automaton.chordSlotBase[ref.combo];
+            bool complete = true;
+            for (size_t m = 0; m < combo.steps.size() && complete; ++m) {
+                const uint64_t pressed = chordPress[base + m];
+                complete = pressed != 0 && timestamp - pressed <= combo.windowNanos;
+            }
+            if (complete) {
+                for (size_t m = 0; m < combo.steps.size(); ++m) chordPress[base + m] = 0;
+                emit(combo.action, timestamp);
+            }
+        }
+    }
+
+    uint64_t automatonId = 0;
+    uint32_t state = 0;
+    uint64_t fed = 0;                // 已输入的序列符号数
+    std::vector<uint64_t> history;   // 最近 maxDepth 个序列符号的时间戳
+    std::vector<uint64_t> chordPress; // 同时按下类连招各成员最近一次按下的时间
+};
+
+#endif // COMBO_AUTOMATON_H
@@ -1,6 +1,19 @@
 #include "Command.h"
+#include "CommandBuffer.h"
 
 // 目前所有 Command 的实现都在 Command.h 中作为内联或模板提供
 // 如果有非内联的 Command 实现，可以放在这里。
 // 例如，如果 ICommand 有非纯虚的析构函数，其定义应在此处。
-// ICommand::~ICommand() = default; // 如果在 .h 中声明了但未定义，可以在此定义
\ No newline at end of file
+// ICommand::~ICommand() = default; // 如果在 .h 中声明了但未定义，可以在此定义
+
+// 与 GameActionCommand::execute 输出格式一致的默认命令回调
+void printActionCommand(void* context, const ActionCommand& command) {
+    InputLog& log = InputLog::instance();
+    if (!log.enabled(LogCategory::Action, LogLevel::Info)) return;
+    const BindingTable& bindings = **static_cast<const BindingTable* const*>(context);
+    // 延迟执行时绑定表可能已被热重载，动作编号不在新表中的命令不再打印
+    if (command.action >= bindings.actionCount()) return;
+    // 动作名在此解析后随记录复制，输出时不再依赖绑定表
+    log.event(LogLevel::Info, LogCategory::Action, "执行动作: ", command.source, nullptr, 0,
+              bindings.action(command.action).name);
+}
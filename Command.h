@@ -3,7 +3,7 @@
 
 #include "ActionMap.h" // 用于GameAction
 #include "DeviceEvent.h"
-#include <iostream> // 用于std::cout示例命令
+#include "InputLog.h" // 用于示例命令的日志输出
 #include <memory>   // 用于std::shared_ptr
 #include <string>
 #include <vector>
@@ -32,18 +32,8 @@ public:
   void execute(/* GameContext& context */) override {
     // 实际游戏逻辑会在这里被调用
     // 例如：context.getPlayer()->performAction(action.name);
-    if (triggerEvent.device == DeviceType::Touch &&
-        (triggerEvent.type == EventType::TouchDown ||
-         triggerEvent.type == EventType::TouchUp)) {
-      std::cout << "执行动作: " << action.name
-                << " (由设备触发: " << deviceTypeToString(triggerEvent.device)
-                << ", 事件类型:" << eventTypeToString(triggerEvent.type) << ")"
-                << std::endl;
-    } else {
-      std::cout << "执行动作: " << action.name
-                << " (由设备触发: " << deviceTypeToString(triggerEvent.device)
-                << ")" << std::endl;
-    }
+    InputLog::instance().event(LogLevel::Info, LogCategory::Action, "执行动作: ",
+                               triggerEvent, nullptr, 0, action.name);
   }
 
   GameAction getAction() const override { return action; }
@@ -0,0 +1,95 @@
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include "BindingTable.h"
+#include "DeviceEvent.h"
+#include "InputMetrics.h"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// 紧凑的命令记录（POD）：动作编号 + 触发它的原始事件
+struct ActionCommand {
+    ActionId action;
+    DeviceEvent source;
+};
+
+// 类型擦除的命令回调：context 由注册方提供，通常指向游戏对象
+using CommandCallback = void (*)(void* context, const ActionCommand& command);
+
+// 命令回调表：按 ActionId 直接索引，执行时无虚函数调用、无分配
+class CommandHandlerTable {
+public:
+    // 为某个动作注册回调（非热路径，可能扩容）
+    void setHandler(ActionId action, CommandCallback callback, void* context = nullptr) {
+        if (action >= entries.size()) entries.resize(static_cast<size_t>(action) + 1);
+        entries[action] = Entry{callback, context};
+    }
+
+    // 未单独注册回调的动作使用默认回调
+    void setDefaultHandler(CommandCallback callback, void* context = nullptr) {
+        fallback = Entry{callback, context};
+    }
+
+    void execute(const ActionCommand& command) const {
+        const Entry& entry = (command.action < entries.size() && entries[command.action].callback)
+                                 ? entries[command.action]
+                                 : fallback;
+        if (entry.callback) entry.callback(entry.context, command);
+    }
+
+private:
+    struct Entry {
+        CommandCallback callback = nullptr;
+        void* context = nullptr;
+    };
+    std::vector<Entry> entries;
+    Entry fallback;
+};
+
+// 固定容量的每帧命令池：容量在构造时一次性分配，之后只复用。
+// 容量至少为 1：池满时调用方 flush 后重试，空池会让命令无处可放
+class CommandArena {
+public:
+    explicit CommandArena(size_t capacity = 1024)
+        : storage(new ActionCommand[std::max<size_t>(capacity, 1)]), cap(std::max<size_t>(capacity, 1)) {}
+
+    // 池满时返回 false，调用方应先 flush 再继续
+    bool push(ActionId action, const DeviceEvent& source) {
+        if (count == cap) return false;
+        storage[count].action = action;
+        storage[count].source = source;
+        ++count;
+        return true;
+    }
+
+    // 依次执行所有命令并清空
+    void flush(const CommandHandlerTable& handlers) {
+        for (size_t i = 0; i < count; ++i) {
+            handlers.execute(storage[i]);
+        }
+        InputMetrics::add(MetricCounter::CommandsExecuted, count);
+        count = 0;
+    }
+
+    ActionCommand* begin() { return storage.get(); }
+    ActionCommand* end() { return storage.get() + count; }
+    const ActionCommand* begin() const { return storage.get(); }
+    const ActionCommand* end() const { return storage.get() + count; }
+    size_t size() const { return count; }
+    size_t capacity() const { return cap; }
+    bool full() const { return count == cap; }
+    void clear() { count = 0; }
+
+private:
+    std::unique_ptr<ActionCommand[]> storage;
+    size_t cap;
+    size_t count = 0;
+};
+
+// 默认回调：把动作执行信息写入日志（InputLog 的 Action 类别）。context 指向一个
+// const BindingTable* 变量，其中保存执行时使用的绑定表（用于把动作编号解析为动作名）
+void printActionCommand(void* context, const ActionCommand& command);
+
+#endif // COMMAND_BUFFER_H
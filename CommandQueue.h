@@ -0,0 +1,146 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include "CommandBuffer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+
+// 命令队列满时生产者（输入线程）的处理方式
+enum class BackpressurePolicy {
+    DropNewest, // 丢弃新命令并计数，输入线程从不等待
+    Wait        // 让出时间片直到游戏线程腾出空间（消费者必须持续 drain）
+};
+
+// 队列统计：生产者与消费者各自写自己的计数，读取时为近似值
+struct CommandQueueStats {
+    uint64_t pushed = 0;       // 成功入队的命令数
+    uint64_t dropped = 0;      // 队列满被丢弃的命令数（DropNewest）
+    uint64_t waits = 0;        // 队列满时等待的次数（Wait）
+    uint64_t drained = 0;      // 消费者取出的命令数
+    uint64_t batches = 0;      // 非空的 drain 次数
+    size_t highWatermark = 0;  // 入队时观察到的最大长度
+};
+
+// 有界无锁单生产者单消费者命令队列：输入线程发布已解析的命令，
+// 游戏线程在帧内固定位置成批取出执行。
+// 双方各自缓存对方的下标，只在看起来满/空时才读取对方的原子变量；
+// 消费者一次 drain 只发布一次 head，生产者可以在整批执行完后才复用这些槽位。
+// 容量会向上取整为 2 的幂，构造后不再进行任何内存分配。
+class CommandQueue {
+public:
+    explicit CommandQueue(size_t capacity = 4096,
+                          BackpressurePolicy policy = BackpressurePolicy::DropNewest)
+        : mask(roundUpPow2(capacity) - 1),
+          slots(new ActionCommand[mask + 1]),
+          backpressure(policy) {}
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    // 生产者接口（只能由一个线程调用）。返回命令是否入队
+    bool push(const ActionCommand& command) {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask) {
+                if (policy() == BackpressurePolicy::DropNewest) {
+                    bump(dropped);
+                    return false;
+                }
+                bump(waits);
+                do {
+                    std::this_thread::yield();
+                    cachedHead = head.load(std::memory_order_acquire);
+                } while (t - cachedHead > mask);
+            }
+        }
+        slots[t & mask] = command;
+        tail.store(t + 1, std::memory_order_release);
+        bump(pushed);
+        const size_t length = t + 1 - cachedHead;
+        if (length > highWatermark.load(std::memory_order_relaxed)) {
+            highWatermark.store(length, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // 消费者接口（只能由一个线程调用）：把最多 maxBatch 条命令依次交给 fn，返回取出的数量。
+    // drain 开始之后入队的命令留到下一次
+    template <typename Fn>
+    size_t drain(Fn&& fn, size_t maxBatch = std::numeric_limits<size_t>::max()) {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (cachedTail == h) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (cachedTail == h) return 0;
+        }
+        size_t count = cachedTail - h;
+        if (count > maxBatch) count = maxBatch;
+        for (size_t i = 0; i < count; ++i) {
+            fn(static_cast<const ActionCommand&>(slots[(h + i) & mask]));
+        }
+        head.store(h + count, std::memory_order_release);
+        drainedCount.store(drainedCount.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        bump(batches);
+        return count;
+    }
+
+    void setPolicy(BackpressurePolicy p) { backpressure.store(p, std::memory_order_relaxed); }
+    BackpressurePolicy policy() const { return backpressure.load(std::memory_order_relaxed); }
+
+    size_t capacity() const { return mask + 1; }
+
+    // 近似的当前长度（并发下仅供统计）
+    size_t sizeApprox() const {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_relaxed);
+        return t > h ? t - h : 0;
+    }
+
+    CommandQueueStats stats() const {
+        CommandQueueStats s;
+        s.pushed = pushed.load(std::memory_order_relaxed);
+        s.dropped = dropped.load(std::memory_order_relaxed);
+        s.waits = waits.load(std::memory_order_relaxed);
+        s.drained = drainedCount.load(std::memory_order_relaxed);
+        s.batches = batches.load(std::memory_order_relaxed);
+        s.highWatermark = highWatermark.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    static size_t roundUpPow2(size_t v) {
+        size_t p = 2;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    // 单写者计数：不需要原子读改写
+    static void bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    const size_t mask;
+    std::unique_ptr<ActionCommand[]> slots;
+
+    // 生产者独占的缓存行
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+    std::atomic<uint64_t> pushed{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> waits{0};
+    std::atomic<size_t> highWatermark{0};
+
+    // 消费者独占的缓存行
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;
+    std::atomic<uint64_t> drainedCount{0};
+    std::atomic<uint64_t> batches{0};
+
+    alignas(64) std::atomic<BackpressurePolicy> backpressure;
+};
+
+#endif // COMMAND_QUEUE_H
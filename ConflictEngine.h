@@ -0,0 +1,237 @@
+#ifndef CONFLICT_ENGINE_H
+#define CONFLICT_ENGINE_H
+
+#include "DeviceEvent.h"
+#include "EventBatch.h"
+#include <cstddef>
+#include <cstdint>
+
+// 可编译的冲突规则种类；Custom 表示只能通过虚函数逐个调用的自定义策略
+enum class ConflictRuleKind : uint8_t {
+    Custom,
+    LastInputWins,   // 最近一次"接管"输入的设备独占连续输入（方向/摇杆）
+    DevicePriority,  // 优先设备在时间窗内活跃时，屏蔽次优先设备的输入
+    TouchGate        // 触摸按下期间只接受触摸设备的输入
+};
+
+// 策略的可编译描述，由 IConflictResolutionStrategy::describe() 给出
+struct ConflictRule {
+    ConflictRuleKind kind = ConflictRuleKind::Custom;
+    DeviceType preferred = DeviceType::Keyboard;     // DevicePriority
+    DeviceType lessPreferred = DeviceType::Keyboard; // DevicePriority
+    uint64_t windowNanos = 0;                        // LastInputWins / DevicePriority
+
+    static ConflictRule lastInputWins(uint64_t windowNanos) {
+        ConflictRule rule;
+        rule.kind = ConflictRuleKind::LastInputWins;
+        rule.windowNanos = windowNanos;
+        return rule;
+    }
+    static ConflictRule devicePriority(DeviceType preferred, DeviceType lessPreferred, uint64_t windowNanos) {
+        ConflictRule rule;
+        rule.kind = ConflictRuleKind::DevicePriority;
+        rule.preferred = preferred;
+        rule.lessPreferred = lessPreferred;
+        rule.windowNanos = windowNanos;
+        return rule;
+    }
+    static ConflictRule touchGate() {
+        ConflictRule rule;
+        rule.kind = ConflictRuleKind::TouchGate;
+        return rule;
+    }
+};
+
+// 冲突裁决的运行时状态，纯 POD，可整体拷贝保存/恢复
+struct ConflictState {
+    static constexpr size_t kMaxTouchPointers = 16;
+
+    uint64_t lastSeen[kDeviceTypeCount] = {}; // 各设备最近一次输入的时间戳（0 表示从未出现）
+    uint8_t owner = 0;                        // LastInputWins：当前持有连续输入的设备
+    uint8_t hasOwner = 0;
+    // TouchGate：按下中的触点编号。同时按下超过 kMaxTouchPointers 个时，
+    // 多出的只计数，抬起未记录的触点时抵消
+    uint8_t touchCount = 0;
+    uint8_t untrackedTouches = 0;
+    uint16_t touchPointers[kMaxTouchPointers] = {};
+
+    bool touching() const { return touchCount != 0 || untrackedTouches != 0; }
+};
+
+// 把一组内置策略编译成的状态机：规则折叠为按设备索引的屏蔽掩码与时间窗，
+// 每个事件的裁决是若干次数组访问与比较，不涉及虚函数调用和内存分配。
+//
+// 与原先逐个调用策略的区别：状态总是按事件更新（不会因前面的策略拒绝而跳过），
+// 因此结果与策略的添加顺序无关。
+class ConflictEngine {
+public:
+    static_assert(kDeviceTypeCount <= 8, "device masks are stored in uint8_t");
+
+    // 添加一条规则；Custom 规则无法编译，返回 false
+    bool addRule(const ConflictRule& rule) {
+        switch (rule.kind) {
+            case ConflictRuleKind::LastInputWins:
+                // 多条 LastInputWins 取最长的时间窗
+                if (!hasLastInputWins || rule.windowNanos > lastInputWindow) lastInputWindow = rule.windowNanos;
+                hasLastInputWins = true;
+                return true;
+            case ConflictRuleKind::DevicePriority: {
+                if (rule.preferred == rule.lessPreferred) return true;
+                const size_t victim = static_cast<size_t>(rule.lessPreferred);
+                const size_t winner = static_cast<size_t>(rule.preferred);
+                if (!(suppressorMask[victim] & (1u << winner)) || rule.windowNanos > suppressWindow[victim][winner]) {
+                    suppressWindow[victim][winner] = rule.windowNanos;
+                }
+                suppressorMask[victim] |= static_cast<uint8_t>(1u << winner);
+                hasPriority = true;
+                return true;
+            }
+            case ConflictRuleKind::TouchGate:
+                hasTouchGate = true;
+                return true;
+            case ConflictRuleKind::Custom:
+                break;
+        }
+        return false;
+    }
+
+    // 清除所有规则与状态
+    void clear() { *this = ConflictEngine{}; }
+
+    // 只清除运行时状态，保留规则
+    void resetState() { current = ConflictState{}; }
+
+    bool empty() const { return !hasLastInputWins && !hasTouchGate && !hasPriority; }
+
+    // 裁决并更新状态；被拒绝时 rejectedBy（可为空）为拒绝它的规则
+    bool admit(const DeviceEvent& event, ConflictRuleKind* rejectedBy = nullptr) {
+        bool allowed = wouldAdmit(event, rejectedBy);
+        update(event, allowed);
+        return allowed;
+    }
+
+    // 批量裁决：verdicts[i] 为 1 表示 events[i] 应被处理
+    void admitBatch(const DeviceEvent* events, size_t count, uint8_t* verdicts) {
+        for (size_t i = 0; i < count; ++i) {
+            verdicts[i] = admit(events[i]) ? 1 : 0;
+        }
+    }
+
+    // SoA 批次裁决：结果写入 keep 列。keep 已为 0 的事件（被前面阶段丢弃）
+    // 既不裁决也不更新状态，与逐个处理丢弃后的序列一致
+    void admitBatch(EventBatch& batch) {
+        const DeviceType* devices = batch.devices();
+        const EventType* types = batch.types();
+        const uint16_t* pointerIds = batch.pointerIds();
+        const float* values = batch.values();
+        const uint64_t* timestamps = batch.timestamps();
+        uint8_t* keep = batch.keep();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (!keep[i]) continue;
+            // 裁决只用到这五个字段
+            DeviceEvent event{};
+            event.device = devices[i];
+            event.type = types[i];
+            event.pointerId = pointerIds[i];
+            event.value = values[i];
+            event.timestamp = timestamps[i];
+            keep[i] = admit(event) ? 1 : 0;
+        }
+    }
+
+    // 只裁决，不更新状态（用于预览/调试显示）
+    bool wouldAdmit(const DeviceEvent& event, ConflictRuleKind* rejectedBy = nullptr) const {
+        const size_t device = static_cast<size_t>(event.device);
+
+        // 松开类事件先于所有规则判断、总是放行，避免被屏蔽后动作卡在按下状态
+        if (isRelease(event)) {
+            return true;
+        }
+        if (hasTouchGate && current.touching() && event.device != DeviceType::Touch) {
+            if (rejectedBy) *rejectedBy = ConflictRuleKind::TouchGate;
+            return false;
+        }
+
+        const uint8_t suppressors = suppressorMask[device];
+        for (size_t other = 0; suppressors != 0 && other < kDeviceTypeCount; ++other) {
+            if (!(suppressors & (1u << other))) continue;
+            const uint64_t seen = current.lastSeen[other];
+            if (seen != 0 && event.timestamp >= seen && event.timestamp - seen <= suppressWindow[device][other]) {
+                if (rejectedBy) *rejectedBy = ConflictRuleKind::DevicePriority;
+                return false;
+            }
+        }
+
+        if (hasLastInputWins && !isEngage(event) && current.hasOwner && current.owner != device) {
+            const uint64_t seen = current.lastSeen[current.owner];
+            if (event.timestamp >= seen && event.timestamp - seen <= lastInputWindow) {
+                if (rejectedBy) *rejectedBy = ConflictRuleKind::LastInputWins;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const ConflictState& state() const { return current; }
+    void restoreState(const ConflictState& saved) { current = saved; }
+
+private:
+    // 按下类事件：设备"接管"输入的信号
+    static bool isEngage(const DeviceEvent& event) {
+        return event.type == EventType::TouchDown || (event.type == EventType::Button && event.value != 0.0f);
+    }
+    // 松开类事件：触摸抬起、按键松开、方向/摇杆回到 0
+    static bool isRelease(const DeviceEvent& event) {
+        return event.type == EventType::TouchUp ||
+               ((event.type == EventType::Button || event.type == EventType::Directional) && event.value == 0.0f);
+    }
+
+    void update(const DeviceEvent& event, bool allowed) {
+        const size_t device = static_cast<size_t>(event.device);
+        if (event.timestamp > current.lastSeen[device]) {
+            current.lastSeen[device] = event.timestamp;
+        }
+        if (event.device == DeviceType::Touch) {
+            // 多点触摸：只有最后一个触点抬起后触摸门控才解除
+            if (event.type == EventType::TouchDown) touchDown(event.pointerId);
+            else if (event.type == EventType::TouchUp) touchUp(event.pointerId);
+        }
+        if (allowed && !isRelease(event)) {
+            current.owner = static_cast<uint8_t>(device);
+            current.hasOwner = 1;
+        }
+    }
+
+    void touchDown(uint16_t pointer) {
+        for (size_t i = 0; i < current.touchCount; ++i) {
+            if (current.touchPointers[i] == pointer) return;
+        }
+        if (current.touchCount < ConflictState::kMaxTouchPointers) {
+            current.touchPointers[current.touchCount++] = pointer;
+        } else if (current.untrackedTouches < UINT8_MAX) {
+            ++current.untrackedTouches;
+        }
+    }
+
+    void touchUp(uint16_t pointer) {
+        for (size_t i = 0; i < current.touchCount; ++i) {
+            if (current.touchPointers[i] == pointer) {
+                current.touchPointers[i] = current.touchPointers[--current.touchCount];
+                return;
+            }
+        }
+        if (current.untrackedTouches > 0) --current.untrackedTouches;
+    }
+
+    // 编译后的规则
+    uint8_t suppressorMask[kDeviceTypeCount] = {};                 // 哪些设备活跃时会屏蔽该设备
+    uint64_t suppressWindow[kDeviceTypeCount][kDeviceTypeCount] = {};
+    uint64_t lastInputWindow = 0;
+    bool hasLastInputWins = false;
+    bool hasTouchGate = false;
+    bool hasPriority = false;
+
+    ConflictState current;
+};
+
+#endif // CONFLICT_ENGINE_H
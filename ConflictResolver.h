@@ -2,11 +2,12 @@
 #define CONFLICT_RESOLVER_H
 
 #include "Command.h"
+#include "ConflictEngine.h"
 #include "DeviceEvent.h"
-#include <iostream> // For example strategy
+#include "InputClock.h"
+#include "InputMetrics.h"
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 // 冲突解决策略接口 (Strategy Pattern)
@@ -16,82 +17,115 @@ public:
   // 判断是否应该处理输入事件
   virtual bool shouldProcessInput(const DeviceEvent &event) const = 0;
   virtual std::string getName() const = 0;
+  // 可编译的规则描述。返回 Custom 的策略由 ConflictResolver 逐个虚调用；
+  // 内置策略返回具体规则，加入 ConflictResolver 后编译进 ConflictEngine 执行
+  virtual ConflictRule describe() const { return ConflictRule{}; }
 };
 
-// 示例策略：最后输入优先
-class LastInputWinsStrategy : public IConflictResolutionStrategy {
+// 内置策略的公共实现：单独使用时用自带的单规则引擎维护状态
+class CompiledConflictStrategy : public IConflictResolutionStrategy {
 public:
+  explicit CompiledConflictStrategy(const ConflictRule &rule) : rule(rule) {
+    standalone.addRule(rule);
+  }
+
   bool shouldProcessInput(const DeviceEvent &event) const override {
-    // 这里可以添加时间戳比较逻辑
-    return true; // 默认允许处理
+    return standalone.admit(event);
   }
+  ConflictRule describe() const override { return rule; }
+
+private:
+  ConflictRule rule;
+  mutable ConflictEngine standalone;
+};
+
+// 最后输入优先：按下类输入让设备接管连续输入（方向/摇杆），
+// 接管设备在 window 内仍活跃时，其他设备的连续输入被屏蔽
+class LastInputWinsStrategy : public CompiledConflictStrategy {
+public:
+  static constexpr uint64_t kDefaultWindowNanos = 250 * kNanosPerMilli;
+
+  explicit LastInputWinsStrategy(uint64_t windowNanos = kDefaultWindowNanos)
+      : CompiledConflictStrategy(ConflictRule::lastInputWins(windowNanos)) {}
   std::string getName() const override { return "LastInputWins"; }
 };
 
-// 示例策略：特定设备优先
-class DevicePriorityStrategy : public IConflictResolutionStrategy {
+// 特定设备优先：优先设备在 window 内有输入时，屏蔽次优先设备的输入（松开除外）
+class DevicePriorityStrategy : public CompiledConflictStrategy {
 public:
-  DevicePriorityStrategy(DeviceType preferred, DeviceType lessPreferred)
-      : preferredDevice(preferred), lessPreferredDevice(lessPreferred) {}
+  static constexpr uint64_t kDefaultWindowNanos = 200 * kNanosPerMilli;
 
-  bool shouldProcessInput(const DeviceEvent &event) const override {
-    // 如果事件来自优先设备，允许处理
-    if (event.device == preferredDevice) {
-      return true;
-    }
-    // 如果事件来自次优先设备，且当前没有优先设备的事件，允许处理
-    if (event.device == lessPreferredDevice) {
-      // 这里可以添加检查是否有优先设备事件的逻辑
-      return true;
-    }
-    return false;
-  }
+  DevicePriorityStrategy(DeviceType preferred, DeviceType lessPreferred,
+                         uint64_t windowNanos = kDefaultWindowNanos)
+      : CompiledConflictStrategy(
+            ConflictRule::devicePriority(preferred, lessPreferred, windowNanos)) {}
   std::string getName() const override { return "DevicePriority"; }
+};
 
-private:
-  DeviceType preferredDevice;
-  DeviceType lessPreferredDevice;
+// 触摸与方向键冲突解决策略：触摸按下期间只接受触摸设备的输入
+class TouchVsDirectionalStrategy : public CompiledConflictStrategy {
+public:
+  TouchVsDirectionalStrategy() : CompiledConflictStrategy(ConflictRule::touchGate()) {}
+  std::string getName() const override { return "TouchVsDirectional"; }
 };
 
-// 触摸与方向键冲突解决策略
-class TouchVsDirectionalStrategy : public IConflictResolutionStrategy {
+// 冲突解析器：内置策略编译进 ConflictEngine（O(1)、无虚调用），
+// 自定义策略在其后按添加顺序逐个调用
+class ConflictResolver {
 public:
-  TouchVsDirectionalStrategy() : isTouching(false) {}
+  void addStrategy(std::shared_ptr<IConflictResolutionStrategy> strategy) {
+    if (!strategy) {
+      return;
+    }
+    if (!engine.addRule(strategy->describe())) {
+      customStrategies.push_back(strategy);
+    }
+    strategyNames.push_back(strategy->getName());
+  }
 
-  bool shouldProcessInput(const DeviceEvent &event) const override {
-    // 如果是触摸事件，更新触摸状态
-    if (event.device == DeviceType::Touch &&
-        (event.type == EventType::TouchDown ||
-         event.type == EventType::TouchUp)) {
-      isTouching = (event.type == EventType::TouchDown);
-      return true; // 允许处理触摸事件
+  // 裁决事件并更新冲突状态（每个事件调用一次），被过滤的事件按规则计入指标
+  bool admit(const DeviceEvent &event) {
+    ConflictRuleKind rejectedBy = ConflictRuleKind::Custom;
+    if (!engine.admit(event, &rejectedBy)) {
+      InputMetrics::add(filteredCounter(rejectedBy));
+      return false;
     }
-    if (isTouching) {
-      return event.device == DeviceType::Touch;
+    if (!customStrategies.empty() && !customAllow(event)) {
+      InputMetrics::add(MetricCounter::FilteredCustom);
+      return false;
     }
     return true;
   }
 
-  std::string getName() const override { return "TouchVsDirectional"; }
+  // 只判断是否应该处理输入事件，不更新内置规则的状态
+  bool shouldProcessInput(const DeviceEvent &event) const;
+
+  // 清空内置规则的运行时状态（例如切换关卡时）
+  void resetState() { engine.resetState(); }
+
+  const ConflictEngine &getEngine() const { return engine; }
+  ConflictEngine &getEngine() { return engine; }
+  const std::vector<std::string> &getStrategyNames() const { return strategyNames; }
 
 private:
-  mutable bool isTouching; // 标记是否正在触摸
-};
+  bool customAllow(const DeviceEvent &event) const;
 
-// 冲突解析器
-class ConflictResolver {
-public:
-  void addStrategy(std::shared_ptr<IConflictResolutionStrategy> strategy) {
-    if (strategy) {
-      strategies.push_back(strategy);
+  static MetricCounter filteredCounter(ConflictRuleKind kind) {
+    switch (kind) {
+    case ConflictRuleKind::TouchGate:
+      return MetricCounter::FilteredTouchGate;
+    case ConflictRuleKind::DevicePriority:
+      return MetricCounter::FilteredDevicePriority;
+    case ConflictRuleKind::LastInputWins:
+      return MetricCounter::FilteredLastInputWins;
+    default:
+      return MetricCounter::FilteredCustom;
     }
   }
 
-  // 判断是否应该处理输入事件
-  bool shouldProcessInput(const DeviceEvent &event) const;
-
-private:
-  std::vector<std::shared_ptr<IConflictResolutionStrategy>> strategies;
+  ConflictEngine engine;
+  std::vector<std::shared_ptr<IConflictResolutionStrategy>> customStrategies;
+  std::vector<std::string> strategyNames;
 };
 
-#endif // CONFLICT_RESOLVER_H
\ No newline at end of file
+#endif // CONFLICT_RESOLVER_H
@@ -1,23 +1,31 @@
 #ifndef DEVICE_EVENT_H
 #define DEVICE_EVENT_H
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
 // 支持的设备类型
-enum class DeviceType {
+enum class DeviceType : uint8_t {
     Keyboard,
     Touch
 };
 
+// 设备类型数量，用于按设备类型索引的定长数组
+constexpr size_t kDeviceTypeCount = 2;
+
 // 事件类型
-enum class EventType {
+enum class EventType : uint8_t {
     Button,
     Directional,
     TouchDown,
-    TouchUp
+    TouchUp,
+    TouchMove
 };
 
+// 事件类型数量，用于按事件类型索引的定长数组
+constexpr size_t kEventTypeCount = 5;
+
 // 将设备类型转换为字符串
 inline std::string deviceTypeToString(DeviceType type) {
     switch (type) {
@@ -41,18 +49,44 @@ inline std::string eventTypeToString(EventType type) {
             return "TouchDown";
         case EventType::TouchUp:
             return "TouchUp";
+        case EventType::TouchMove:
+            return "TouchMove";
         default:
             return "Unknown";
     }
 }
 
-// 统一的底层事件对象
+// 事件在流水线各阶段的时间点，记录为相对采集时刻（timestamp）的纳秒偏移，
+// 超过 uint32 范围时饱和。0 表示该阶段未记录（需开启 InputTrace）
+struct EventTrace {
+    uint32_t enqueue = 0;  // 进入输入流
+    uint32_t dequeue = 0;  // 被游戏线程取出
+    uint32_t resolve = 0;  // 通过冲突检测
+    uint32_t execute = 0;  // 命令开始执行
+};
+
+// 统一的底层事件对象：紧凑的定长记录（48 字节 = 32 字节事件体 + 16 字节延迟追踪），
+// 按值在各阶段间拷贝。需要按列批量处理时使用 EventBatch（见 EventBatch.h）
 struct DeviceEvent {
-    DeviceType device;  // 事件来源设备
-    EventType type;     // 事件类型
-    int code;           // 键码或按钮编号
-    float value;        // 数值（如压力、轴值）
-    uint64_t timestamp; // 时间戳
+    DeviceType device;    // 事件来源设备
+    EventType type;       // 事件类型
+    uint16_t instanceId;  // 设备实例编号（同类设备中的第几个，见 IDeviceAdapter::instanceId）
+    int code;             // 键码或按钮编号
+    float value;          // 数值（如压力、轴值）
+    uint16_t pointerId;   // 触点编号（触摸事件），从按下到抬起保持不变
+    uint16_t reserved;
+    // 附加数据：触摸事件为触点位置（归一化屏幕坐标 0~1，y 轴向下）；
+    // 多轴输入（如双轴摇杆）为 value 之外的另两个轴
+    float x;
+    float y;
+    uint64_t timestamp;   // 采集时间戳，单调时钟纳秒（见 InputClock.h）
+    EventTrace trace;     // 可选的延迟追踪记录
 };
+static_assert(sizeof(DeviceEvent) == 48, "DeviceEvent should stay a packed 48-byte record");
+
+// 是否为"按下"类事件（按键/方向按下、触摸按下与移动），松开与触摸抬起返回 false
+inline bool isPressEvent(const DeviceEvent& event) {
+    return event.type != EventType::TouchUp && event.value != 0.0f;
+}
 
 #endif // DEVICE_EVENT_H
\ No newline at end of file
@@ -1,72 +1,238 @@
 #include "DeviceManager.h"
-#include "KeyboardAdapter.h" // 用于 dynamic_cast
-#include "GamepadAdapter.h"  // 用于 dynamic_cast
 #include <vector>           // 用于 std::vector
 #include <algorithm>        // 用于 std::remove，虽然已在.h中包含，但明确包含是个好习惯
 #include <mutex>            // 用于 std::lock_guard，虽然已在.h中包含
+#include <chrono>
+#include <stdexcept>
+#include "InputClock.h"
+#include "InputLog.h"
+#include "InputMetrics.h"
+
+namespace {
+// 把适配器输出直接写入输入流（采样线程使用）
+class RingEventSink : public EventSink {
+public:
+    explicit RingEventSink(EventRing& ring) : ring(ring) {}
+    void push(const DeviceEvent& event) override {
+        DeviceEvent traced = event;
+        InputTrace::mark(traced, TraceStage::Enqueue);
+        ring.push(traced);
+    }
+
+private:
+    EventRing& ring;
+};
+
+// 由适配器列表重建按类型分的桶
+std::shared_ptr<const AdapterRegistry> makeRegistry(std::vector<std::shared_ptr<IDeviceAdapter>> adapters) {
+    auto next = std::make_shared<AdapterRegistry>();
+    next->adapters = std::move(adapters);
+    for (const auto& adapter : next->adapters) {
+        size_t bucket = adapter->hasDeviceType() ? static_cast<size_t>(adapter->deviceType())
+                                                 : AdapterRegistry::kUntypedBucket;
+        next->buckets[bucket].push_back(adapter.get());
+    }
+    return next;
+}
+} // namespace
 
 DeviceManager& DeviceManager::instance() {
     static DeviceManager mgr;
     return mgr;
 }
 
-void DeviceManager::registerAdapter(std::shared_ptr<IDeviceAdapter> adapter) {
-    std::lock_guard<std::mutex> lk(mtx);
-    if (adapter) {
-        adapters.push_back(adapter);
+DeviceManager::~DeviceManager() {
+    stopSampling();
+}
+
+bool DeviceManager::registerAdapter(std::shared_ptr<IDeviceAdapter> adapter) {
+    if (!adapter) return false;
+    std::lock_guard<std::mutex> lk(registryMtx);
+    std::shared_ptr<const AdapterRegistry> current = registry.share();
+    if (adapter->hasDeviceType()) {
+        for (IDeviceAdapter* existing : current->bucket(adapter->deviceType())) {
+            if (existing == adapter.get() || existing->instanceId() == adapter->instanceId()) {
+                InputLog::instance().message(LogLevel::Warning, LogCategory::Device, "Adapter is already registered: ",
+                                             deviceTypeToString(adapter->deviceType()) + "#" +
+                                                 std::to_string(adapter->instanceId()));
+                return false;
+            }
+        }
+    } else if (std::find(current->adapters.begin(), current->adapters.end(), adapter) !=
+               current->adapters.end()) {
+        return false;
     }
+    std::vector<std::shared_ptr<IDeviceAdapter>> adapters = current->adapters;
+    adapters.push_back(std::move(adapter));
+    registry.publish(makeRegistry(std::move(adapters)));
+    return true;
 }
 
 void DeviceManager::unregisterAdapter(std::shared_ptr<IDeviceAdapter> adapter) {
-    std::lock_guard<std::mutex> lk(mtx);
-    if (adapter) {
-        adapters.erase(
-            std::remove(adapters.begin(), adapters.end(), adapter),
-            adapters.end());
+    if (!adapter) return;
+    // 下面要等待宽限期；在读侧临界区内等待只会等到自己，先于任何改动报错
+    if (RcuDomain::instance().inReadSection()) {
+        throw std::logic_error("DeviceManager::unregisterAdapter called inside a read-side critical section");
+    }
+    std::lock_guard<std::mutex> lk(registryMtx);
+    std::shared_ptr<const AdapterRegistry> current = registry.share();
+    std::vector<std::shared_ptr<IDeviceAdapter>> adapters = current->adapters;
+    adapters.erase(
+        std::remove(adapters.begin(), adapters.end(), adapter),
+        adapters.end());
+    if (adapters.size() == current->adapters.size()) return;
+    current.reset();
+    registry.publish(makeRegistry(std::move(adapters)));
+    // 等待正在进行的轮询结束，保证返回后不会再有线程调用该适配器
+    registry.synchronize();
+}
+
+std::shared_ptr<IDeviceAdapter> DeviceManager::findAdapter(DeviceType type, uint32_t instanceId) const {
+    std::shared_ptr<const AdapterRegistry> current = registry.share();
+    for (const auto& adapter : current->adapters) {
+        if (adapter->hasDeviceType() && adapter->deviceType() == type && adapter->instanceId() == instanceId) {
+            return adapter;
+        }
+    }
+    return nullptr;
+}
+
+size_t DeviceManager::adapterCount(DeviceType type) const {
+    RcuReadGuard guard;
+    return registry.get()->bucket(type).size();
+}
+
+void DeviceManager::pollEvents(std::vector<DeviceEvent>& out) {
+    MetricsTimer timer(MetricHistogram::PollNanos);
+    out.clear();
+    runs.clear();
+    int priorities[kDeviceTypeCount];
+    for (size_t i = 0; i < kDeviceTypeCount; ++i) {
+        priorities[i] = devicePriority[i].load(std::memory_order_relaxed);
+    }
+    uint32_t streamOrder = 0;
+    {
+        // 在 RCU 读侧读取适配器列表：热插拔不会阻塞这里，这里也不会阻塞热插拔
+        RcuReadGuard guard;
+        const std::vector<std::shared_ptr<IDeviceAdapter>>& adapters = registry.get()->adapters;
+        // 采样线程运行时适配器由它负责轮询，这里只取出已积累的事件
+        const size_t polledAdapters = isSampling() ? 0 : adapters.size();
+        // 输入流排在所有适配器之后；用适配器总数而不是已收集的段数，禁用的适配器不会造成序号重复
+        streamOrder = static_cast<uint32_t>(adapters.size());
+        if (adapterRuns.size() < adapters.size()) {
+            adapterRuns.resize(adapters.size());
+        }
+        for (size_t i = 0; i < polledAdapters; ++i) {
+            const auto& adapter = adapters[i];
+            std::vector<DeviceEvent>& run = adapterRuns[i];
+            run.clear();
+            if (adapter->isEnabled()) {
+                VectorEventSink sink(run);
+                adapter->pollInto(sink);
+                if (InputTrace::isEnabled()) {
+                    for (DeviceEvent& event : run) InputTrace::mark(event, TraceStage::Enqueue);
+                }
+                // 适配器输出通常已有序，这里只做兜底
+                sortEventRun(run.data(), run.data() + run.size());
+                runs.push_back(EventRun{run.data(), run.data() + run.size(),
+                                        static_cast<uint32_t>(i)});
+            }
+        }
+    }
+
+    // 不同线程投递的事件可能交错，排序后作为额外的一段参与归并。
+    // 采样线程运行时所有适配器的事件都在这一段里，段内同样按设备优先级处理并列
+    streamRun.clear();
+    eventStream.drain([&](const DeviceEvent& event) { streamRun.push_back(event); });
+    sortEventRun(streamRun.data(), streamRun.data() + streamRun.size(), priorities);
+    runs.push_back(EventRun{streamRun.data(), streamRun.data() + streamRun.size(),
+                            streamOrder});
+
+    merger.merge(runs.data(), runs.size(), priorities,
+                 [&](const DeviceEvent& event) {
+                     out.push_back(event);
+                     InputTrace::mark(out.back(), TraceStage::Dequeue);
+                 });
+
+    if constexpr (InputMetrics::kEnabled) {
+        // 先在本地按设备计数，每种设备只更新一次计数器
+        uint64_t perDevice[kDeviceTypeCount] = {};
+        for (const DeviceEvent& event : out) ++perDevice[static_cast<size_t>(event.device)];
+        for (size_t d = 0; d < kDeviceTypeCount; ++d) {
+            if (perDevice[d]) InputMetrics::add(eventsCounter(static_cast<DeviceType>(d)), perDevice[d]);
+        }
     }
 }
 
 std::vector<DeviceEvent> DeviceManager::pollEvents() {
-    std::lock_guard<std::mutex> lk(mtx);
     std::vector<DeviceEvent> allEvents;
-    for (const auto& adapter : adapters) {
-        if (adapter && adapter->isEnabled()) {
-            std::vector<DeviceEvent> deviceEvents = adapter->pollEvents();
-            // 将 deviceEvents 中的所有元素追加到 allEvents 的末尾
-            allEvents.insert(allEvents.end(), deviceEvents.begin(), deviceEvents.end());
+    pollEvents(allEvents);
+    return allEvents;
+}
+
+void DeviceManager::startSampling(uint32_t sampleRateHz) {
+    std::lock_guard<std::mutex> lk(samplingMtx);
+    if (samplingActive.load(std::memory_order_acquire)) {
+        return;
+    }
+    const uint64_t periodNanos = sampleRateHz ? 1000 * kNanosPerMilli / sampleRateHz : kNanosPerMilli;
+    samplingActive.store(true, std::memory_order_release);
+    samplingThread = std::thread(&DeviceManager::samplingLoop, this, periodNanos);
+}
+
+void DeviceManager::stopSampling() {
+    std::lock_guard<std::mutex> lk(samplingMtx);
+    samplingActive.store(false, std::memory_order_release);
+    if (samplingThread.joinable()) {
+        samplingThread.join();
+    }
+}
+
+void DeviceManager::pollAdaptersInto(const AdapterRegistry& current, EventSink& sink) {
+    for (const auto& adapter : current.adapters) {
+        if (adapter->isEnabled()) {
+            adapter->pollInto(sink);
         }
     }
-    return allEvents;
 }
 
-void DeviceManager::enableDevice(DeviceType type, bool on) {
-    std::lock_guard<std::mutex> lk(mtx);
-    for (auto& adapter : adapters) {
-        if (!adapter) continue;
-        bool typeMatch = false;
-        // 使用 dynamic_cast 检查适配器的实际类型
-        if (type == DeviceType::Keyboard) {
-            if (dynamic_cast<KeyboardAdapter*>(adapter.get())) {
-                typeMatch = true;
-            }
-        } else if (type == DeviceType::Touch) {
-            if (dynamic_cast<GamepadAdapter*>(adapter.get())) {
-                typeMatch = true;
-            }
+void DeviceManager::samplingLoop(uint64_t periodNanos) {
+    RingEventSink sink(eventStream);
+    auto nextTick = std::chrono::steady_clock::now();
+    const auto period = std::chrono::nanoseconds(periodNanos);
+    while (samplingActive.load(std::memory_order_acquire)) {
+        {
+            RcuReadGuard guard;
+            pollAdaptersInto(*registry.get(), sink);
         }
-        if (typeMatch) {
-            adapter->enable(on);
+        // 按固定节拍采样；落后太多时不追赶，直接从当前时刻重新计时
+        nextTick += period;
+        auto now = std::chrono::steady_clock::now();
+        if (nextTick < now) {
+            nextTick = now;
+        } else {
+            std::this_thread::sleep_until(nextTick);
         }
     }
 }
 
+void DeviceManager::setDevicePriority(DeviceType type, int priority) {
+    devicePriority[static_cast<size_t>(type)].store(priority, std::memory_order_relaxed);
+}
+
+void DeviceManager::enableDevice(DeviceType type, bool on) {
+    RcuReadGuard guard;
+    for (IDeviceAdapter* adapter : registry.get()->bucket(type)) {
+        adapter->enable(on);
+    }
+}
+
 // 新增：设置当前活跃设备
 void DeviceManager::setActiveDevice(DeviceType type) {
-    std::lock_guard<std::mutex> lk(mtx);
-    activeDevice = type;
+    activeDevice.store(type, std::memory_order_relaxed);
 }
 
 // 新增：获取当前活跃设备
 DeviceType DeviceManager::getActiveDevice() const {
-    return activeDevice;
-}
\ No newline at end of file
+    return activeDevice.load(std::memory_order_relaxed);
+}
@@ -3,24 +3,78 @@
 
 #include "IDeviceAdapter.h"
 #include "DeviceEvent.h" // 为 DeviceType 添加
+#include "EventMerge.h"
+#include "EventRing.h"
+#include "InputTrace.h"
+#include "Rcu.h"
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <thread>
 #include <algorithm> // 为 std::remove 添加
 
+// 适配器注册表快照：注册顺序的完整列表，以及按声明的设备类型分好的桶。
+// 只读，注册/移除时整体复制后通过 RCU 发布。
+struct AdapterRegistry {
+    static constexpr size_t kUntypedBucket = kDeviceTypeCount; // 未声明类型的适配器
+
+    std::vector<std::shared_ptr<IDeviceAdapter>> adapters;
+    std::vector<IDeviceAdapter*> buckets[kDeviceTypeCount + 1];
+
+    const std::vector<IDeviceAdapter*>& bucket(DeviceType type) const {
+        return buckets[static_cast<size_t>(type)];
+    }
+};
+
 class DeviceManager {
 public:
     // 单例获取
     static DeviceManager& instance();
 
-    // 注册／移除适配器
-    void registerAdapter(std::shared_ptr<IDeviceAdapter> adapter);
+    // 注册／移除适配器（热插拔）。写者之间互斥，但从不阻塞轮询：
+    // 新列表复制后原子发布，轮询线程在下一次轮询时看到。
+    // 同一类型、同一实例编号的适配器只能注册一个，重复注册返回 false。
+    bool registerAdapter(std::shared_ptr<IDeviceAdapter> adapter);
+    // 返回时被移除的适配器已不会再被任何轮询调用。会等待 RCU 宽限期：不要在适配器
+    // 回调中调用，调用线程也不能持有任何读侧临界区（BindingSnapshot、ActionStateView、
+    // RcuReadGuard 等），否则会等待自己而死锁；检测到时抛出 std::logic_error
     void unregisterAdapter(std::shared_ptr<IDeviceAdapter> adapter);
 
-    // 拉取所有适配器事件
+    // 按类型与实例编号查找已注册的适配器
+    std::shared_ptr<IDeviceAdapter> findAdapter(DeviceType type, uint32_t instanceId) const;
+    size_t adapterCount(DeviceType type) const;
+
+    // 拉取所有适配器事件到调用方复用的缓冲区（先清空 out，稳态下不分配）
+    // 各适配器的事件与输入流中的事件按时间戳多路归并为一条有序流。
+    // 只应由消费者线程（游戏线程）调用。
+    void pollEvents(std::vector<DeviceEvent>& out);
+    // 兼容接口：每次返回新的 vector
     std::vector<DeviceEvent> pollEvents();
 
-    // 启用／禁用某种类型设备（循环所有适配器判断类型）
+    // 启动独立的输入采样线程：以 sampleRateHz 的频率轮询适配器并打上时间戳，
+    // 与渲染帧率解耦。运行期间 pollEvents 只取出已积累的事件，不再直接轮询适配器。
+    // 自带线程、事件驱动的适配器应直接调用 submitEvent。
+    void startSampling(uint32_t sampleRateHz = 1000);
+    void stopSampling();
+    bool isSampling() const { return samplingActive.load(std::memory_order_acquire); }
+
+    // 投递事件到输入流（无锁，适配器可在自己的线程中调用，不会阻塞消费者）
+    bool submitEvent(const DeviceEvent& event) {
+        DeviceEvent traced = event;
+        InputTrace::mark(traced, TraceStage::Enqueue);
+        return eventStream.push(traced);
+    }
+
+    // 输入流溢出策略与统计
+    void setOverflowPolicy(OverflowPolicy policy) { eventStream.setOverflowPolicy(policy); }
+    uint64_t droppedEventCount() const { return eventStream.droppedCount(); }
+    uint64_t takeOverflowReport() { return eventStream.takeOverflowReport(); }
+
+    // 设置设备优先级：时间戳相同时优先级高的设备事件排在前面
+    void setDevicePriority(DeviceType type, int priority);
+
+    // 启用／禁用某种类型的全部适配器（只访问该类型的桶，不加锁）
     void enableDevice(DeviceType type, bool on);
 
     // 新增：设置和获取当前活跃设备
@@ -29,9 +83,40 @@ public:
 
 private:
     DeviceManager() = default;
-    std::vector<std::shared_ptr<IDeviceAdapter>> adapters;
-    std::mutex mtx;
-    DeviceType activeDevice = DeviceType::Keyboard; // 默认活跃设备
+    ~DeviceManager();
+    DeviceManager(const DeviceManager&) = delete;
+    DeviceManager& operator=(const DeviceManager&) = delete;
+
+    // 轮询所有已启用的适配器
+    void pollAdaptersInto(const AdapterRegistry& current, EventSink& sink);
+    void samplingLoop(uint64_t periodNanos);
+
+    RcuCell<AdapterRegistry> registry{std::make_shared<const AdapterRegistry>()};
+    std::mutex registryMtx; // 只串行化注册/移除，轮询路径不加锁
+    EventRing eventStream; // 单一输入流，所有设备事件经此交给游戏线程
+
+    std::thread samplingThread;
+    std::atomic<bool> samplingActive{false};
+    std::mutex samplingMtx; // 串行化 startSampling / stopSampling
+
+    // 以下仅由消费者线程使用，容量在帧间复用
+    std::vector<std::vector<DeviceEvent>> adapterRuns; // 每个适配器一段事件
+    std::vector<DeviceEvent> streamRun;                // 其他线程投递的事件
+    std::vector<EventRun> runs;
+    EventMerger merger;
+    std::atomic<int> devicePriority[kDeviceTypeCount] = {{0}, {1}}; // 默认触屏优先于键盘
+    std::atomic<DeviceType> activeDevice{DeviceType::Keyboard};     // 默认活跃设备
+};
+
+// 投递到 DeviceManager 输入流的接收端：自带线程的适配器（如 SyntheticAdapter::start）
+// 可以直接写入，多个线程同时写入是安全的
+class InputStreamSink : public EventSink {
+public:
+    explicit InputStreamSink(DeviceManager& manager) : manager(manager) {}
+    void push(const DeviceEvent& event) override { manager.submitEvent(event); }
+
+private:
+    DeviceManager& manager;
 };
 
 #endif // DEVICE_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "EventBatch.h"
+#include <algorithm>
+
+void EventBatch::reserve(size_t capacity) {
+    device.reserve(capacity);
+    type.reserve(capacity);
+    instanceId.reserve(capacity);
+    code.reserve(capacity);
+    value.reserve(capacity);
+    pointerId.reserve(capacity);
+    x.reserve(capacity);
+    y.reserve(capacity);
+    timestamp.reserve(capacity);
+    trace.reserve(capacity);
+    keepMask.reserve(capacity);
+}
+
+void EventBatch::ensureRows(size_t n) {
+    if (device.size() >= n) return;
+    // 按倍数扩容，避免逐个 push_back 时每次都调整 11 列
+    size_t rows = device.size() ? device.size() : 64;
+    while (rows < n) rows *= 2;
+    device.resize(rows);
+    type.resize(rows);
+    instanceId.resize(rows);
+    code.resize(rows);
+    value.resize(rows);
+    pointerId.resize(rows);
+    x.resize(rows);
+    y.resize(rows);
+    timestamp.resize(rows);
+    trace.resize(rows);
+    keepMask.resize(rows);
+}
+
+void EventBatch::push_back(const DeviceEvent& event) {
+    ensureRows(count + 1);
+    const size_t i = count++;
+    device[i] = event.device;
+    type[i] = event.type;
+    instanceId[i] = event.instanceId;
+    code[i] = event.code;
+    value[i] = event.value;
+    pointerId[i] = event.pointerId;
+    x[i] = event.x;
+    y[i] = event.y;
+    timestamp[i] = event.timestamp;
+    trace[i] = event.trace;
+    keepMask[i] = 1;
+}
+
+void EventBatch::assign(const DeviceEvent* events, size_t n) {
+    ensureRows(n);
+    count = n;
+    for (size_t i = 0; i < n; ++i) {
+        const DeviceEvent& event = events[i];
+        device[i] = event.device;
+        type[i] = event.type;
+        instanceId[i] = event.instanceId;
+        code[i] = event.code;
+        value[i] = event.value;
+        pointerId[i] = event.pointerId;
+        x[i] = event.x;
+        y[i] = event.y;
+        timestamp[i] = event.timestamp;
+        trace[i] = event.trace;
+    }
+    std::fill(keepMask.begin(), keepMask.begin() + n, 1);
+}
+
+DeviceEvent EventBatch::event(size_t i) const {
+    DeviceEvent event{};
+    event.device = device[i];
+    event.type = type[i];
+    event.instanceId = instanceId[i];
+    event.code = code[i];
+    event.value = value[i];
+    event.pointerId = pointerId[i];
+    event.x = x[i];
+    event.y = y[i];
+    event.timestamp = timestamp[i];
+    event.trace = trace[i];
+    return event;
+}
+
+size_t EventBatch::exportTo(std::vector<DeviceEvent>& out) const {
+    out.resize(keptCount());
+    size_t o = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (keepMask[i]) out[o++] = event(i);
+    }
+    return o;
+}
+
+size_t EventBatch::compact() {
+    size_t o = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!keepMask[i]) continue;
+        if (o != i) {
+            device[o] = device[i];
+            type[o] = type[i];
+            instanceId[o] = instanceId[i];
+            code[o] = code[i];
+            value[o] = value[i];
+            pointerId[o] = pointerId[i];
+            x[o] = x[i];
+            y[o] = y[i];
+            timestamp[o] = timestamp[i];
+            trace[o] = trace[i];
+            keepMask[o] = 1;
+        }
+        ++o;
+    }
+    count = o;
+    return o;
+}
+
+size_t EventBatch::keptCount() const {
+    size_t kept = 0;
+    for (size_t i = 0; i < count; ++i) kept += keepMask[i];
+    return kept;
+}
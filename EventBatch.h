@@ -0,0 +1,84 @@
+#ifndef EVENT_BATCH_H
+#define EVENT_BATCH_H
+
+#include "DeviceEvent.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 一帧事件的结构数组（SoA）形式：每个字段一列。
+// 批量阶段（过滤、合并、冲突裁决）只读写需要的列，同类型数据连续存放，便于向量化；
+// 列的容量在帧间保留，稳态下不再分配。
+//
+// keep 列是各阶段共享的掩码：0 表示事件已被丢弃。阶段之间只改掩码不搬移数据，
+// 最后由 compact() 或 exportTo() 统一移除。
+class EventBatch {
+public:
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void clear() { count = 0; }
+    void reserve(size_t capacity);
+
+    // 追加一个事件（keep = 1）
+    void push_back(const DeviceEvent& event);
+
+    // 用 AoS 事件序列整体替换内容
+    void assign(const DeviceEvent* events, size_t n);
+    void assign(const std::vector<DeviceEvent>& events) { assign(events.data(), events.size()); }
+
+    // 还原第 i 个事件
+    DeviceEvent event(size_t i) const;
+
+    // 以 AoS 形式输出保留的事件（替换 out 的内容），返回输出数
+    size_t exportTo(std::vector<DeviceEvent>& out) const;
+
+    // 原地移除 keep 为 0 的事件，返回剩余数
+    size_t compact();
+
+    // 保留的事件数
+    size_t keptCount() const;
+
+    // ---- 列访问：下标 [0, size()) 有效 ----
+    DeviceType* devices() { return device.data(); }
+    const DeviceType* devices() const { return device.data(); }
+    EventType* types() { return type.data(); }
+    const EventType* types() const { return type.data(); }
+    uint16_t* instanceIds() { return instanceId.data(); }
+    const uint16_t* instanceIds() const { return instanceId.data(); }
+    int* codes() { return code.data(); }
+    const int* codes() const { return code.data(); }
+    float* values() { return value.data(); }
+    const float* values() const { return value.data(); }
+    uint16_t* pointerIds() { return pointerId.data(); }
+    const uint16_t* pointerIds() const { return pointerId.data(); }
+    float* xs() { return x.data(); }
+    const float* xs() const { return x.data(); }
+    float* ys() { return y.data(); }
+    const float* ys() const { return y.data(); }
+    uint64_t* timestamps() { return timestamp.data(); }
+    const uint64_t* timestamps() const { return timestamp.data(); }
+    EventTrace* traces() { return trace.data(); }
+    const EventTrace* traces() const { return trace.data(); }
+    uint8_t* keep() { return keepMask.data(); }
+    const uint8_t* keep() const { return keepMask.data(); }
+
+private:
+    // 各列长度至少为 n（只增不减）
+    void ensureRows(size_t n);
+
+    size_t count = 0;
+    std::vector<DeviceType> device;
+    std::vector<EventType> type;
+    std::vector<uint16_t> instanceId;
+    std::vector<int> code;
+    std::vector<float> value;
+    std::vector<uint16_t> pointerId;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<uint64_t> timestamp;
+    std::vector<EventTrace> trace;
+    std::vector<uint8_t> keepMask;
+};
+
+#endif // EVENT_BATCH_H
@@ -0,0 +1,194 @@
+#include "EventCoalescer.h"
+
+namespace {
+
+// AoS 事件序列的行访问
+struct EventRows {
+    std::vector<DeviceEvent>& events;
+
+    DeviceType device(size_t i) const { return events[i].device; }
+    EventType type(size_t i) const { return events[i].type; }
+    int code(size_t i) const { return events[i].code; }
+    uint16_t instanceId(size_t i) const { return events[i].instanceId; }
+    uint16_t pointerId(size_t i) const { return events[i].pointerId; }
+    float& value(size_t i) { return events[i].value; }
+};
+
+// SoA 批次的行访问：只触及合并需要的列
+struct BatchRows {
+    const DeviceType* devices;
+    const EventType* types;
+    const int* codes;
+    const uint16_t* instanceIds;
+    const uint16_t* pointerIds;
+    float* values;
+
+    explicit BatchRows(EventBatch& batch)
+        : devices(batch.devices()), types(batch.types()), codes(batch.codes()),
+          instanceIds(batch.instanceIds()), pointerIds(batch.pointerIds()), values(batch.values()) {}
+
+    DeviceType device(size_t i) const { return devices[i]; }
+    EventType type(size_t i) const { return types[i]; }
+    int code(size_t i) const { return codes[i]; }
+    uint16_t instanceId(size_t i) const { return instanceIds[i]; }
+    uint16_t pointerId(size_t i) const { return pointerIds[i]; }
+    float& value(size_t i) { return values[i]; }
+};
+
+} // namespace
+
+CoalescePolicy EventCoalescer::policyFor(DeviceType device, int code, EventType type) const {
+    if (isEdgeEvent(type)) {
+        return CoalescePolicy::None;
+    }
+    if (!overrides.empty()) {
+        auto it = overrides.find(makeKey(device, code, type));
+        if (it != overrides.end()) return it->second;
+    }
+    return defaults[static_cast<size_t>(type)];
+}
+
+EventCoalescer::Group& EventCoalescer::findGroup(uint64_t key, uint16_t instance, bool& created) {
+    const uint64_t mixed = key ^ (static_cast<uint64_t>(instance) << 17);
+    size_t h = static_cast<size_t>((mixed ^ (mixed >> 29)) * 0x9E3779B97F4A7C15ULL);
+    for (size_t i = h & groupMask;; i = (i + 1) & groupMask) {
+        Group& group = groups[i];
+        if (group.generation != generation) {
+            group.key = key;
+            group.instance = instance;
+            group.generation = generation;
+            created = true;
+            return group;
+        }
+        if (group.key == key && group.instance == instance) {
+            created = false;
+            return group;
+        }
+    }
+}
+
+void EventCoalescer::beginFrame(size_t n) {
+    // 分组表容量至少为事件数的两倍；只在帧变大时扩容
+    size_t capacity = groups.size() ? groups.size() : 16;
+    while (capacity < n * 2) capacity <<= 1;
+    if (capacity != groups.size()) {
+        groups.assign(capacity, Group{});
+        groupMask = capacity - 1;
+        generation = 0;
+    }
+    nextGeneration();
+}
+
+void EventCoalescer::nextGeneration() {
+    if (++generation == 0) {
+        // 代数回绕时清空，避免旧分组被误认为当前这一代
+        for (Group& group : groups) group.generation = 0;
+        generation = 1;
+    }
+}
+
+template <typename Rows>
+bool EventCoalescer::markMerged(Rows& rows, size_t n, uint8_t* keep) {
+    bool anyMerged = false;
+    for (size_t i = 0; i < n; ++i) {
+        if (!keep[i]) continue;
+        const DeviceType device = rows.device(i);
+        const EventType type = rows.type(i);
+        const int code = rows.code(i);
+        if (isEdgeEvent(type)) {
+            // 边沿事件之前与之后的更新不合并：冲突检测（如触摸门控）与动作状态
+            // 依赖它们相对边沿的先后顺序。开始新的一代即关闭全部分组
+            nextGeneration();
+            continue;
+        }
+        CoalescePolicy policy = policyFor(device, code, type);
+        if (policy == CoalescePolicy::None) continue;
+
+        bool created = false;
+        Group& group = findGroup(groupKey(device, code, type, rows.pointerId(i)), rows.instanceId(i), created);
+        const uint32_t index = static_cast<uint32_t>(i);
+        const float value = rows.value(i);
+        if (value == 0.0f) {
+            // 归零（方向松开）原样保留并结束这一段，只合并连续的非零值
+            group.open = false;
+            continue;
+        }
+        if (created || !group.open) {
+            group.open = true;
+            group.lastIndex = group.minIndex = group.maxIndex = index;
+            group.accumulated = value;
+            continue;
+        }
+
+        anyMerged = true;
+        switch (policy) {
+            case CoalescePolicy::KeepLatest:
+                keep[group.lastIndex] = 0;
+                group.lastIndex = index;
+                break;
+            case CoalescePolicy::AccumulateDelta:
+                keep[group.lastIndex] = 0;
+                group.lastIndex = index;
+                group.accumulated += value;
+                rows.value(i) = group.accumulated;
+                break;
+            case CoalescePolicy::KeepMinMax: {
+                // 被替换的旧极值事件若仍是另一端的极值则保留
+                const bool newMin = value < rows.value(group.minIndex);
+                const bool newMax = value > rows.value(group.maxIndex);
+                if (newMin) {
+                    uint32_t previous = group.minIndex;
+                    group.minIndex = index;
+                    if (previous != group.maxIndex) keep[previous] = 0;
+                }
+                if (newMax) {
+                    uint32_t previous = group.maxIndex;
+                    group.maxIndex = index;
+                    if (previous != group.minIndex) keep[previous] = 0;
+                }
+                if (!newMin && !newMax) keep[i] = 0;
+                break;
+            }
+            case CoalescePolicy::None:
+                break;
+        }
+    }
+    return anyMerged;
+}
+
+size_t EventCoalescer::coalesce(std::vector<DeviceEvent>& events) {
+    const size_t n = events.size();
+    inputCount = n;
+    outputCount = n;
+    if (n < 2) return n;
+
+    beginFrame(n);
+    keep.assign(n, 1);
+    EventRows rows{events};
+    if (!markMerged(rows, n, keep.data())) return n;
+
+    size_t out = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (keep[i]) {
+            if (out != i) events[out] = events[i];
+            ++out;
+        }
+    }
+    events.resize(out);
+    outputCount = out;
+    return out;
+}
+
+size_t EventCoalescer::coalesce(EventBatch& batch) {
+    const size_t n = batch.size();
+    inputCount = batch.keptCount();
+    outputCount = inputCount;
+    if (inputCount < 2) return inputCount;
+
+    beginFrame(n);
+    BatchRows rows(batch);
+    if (!markMerged(rows, n, batch.keep())) return inputCount;
+
+    outputCount = batch.keptCount();
+    return outputCount;
+}
@@ -0,0 +1,104 @@
+#ifndef EVENT_COALESCER_H
+#define EVENT_COALESCER_H
+
+#include "DeviceEvent.h"
+#include "EventBatch.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// 同一 (设备, 输入码, 事件类型) 在一帧内多次出现时的合并策略
+enum class CoalescePolicy : uint8_t {
+    None,            // 不合并，全部保留
+    KeepLatest,      // 只保留最后一个值
+    KeepMinMax,      // 保留本帧最小值与最大值两个事件
+    AccumulateDelta  // 累加所有增量，保留在最后一个事件上
+};
+
+// 每帧事件合并：位于 DeviceManager::pollEvents 与 InputProcessor 之间，
+// 把高频设备产生的冗余方向/轴更新合并，减少后续冲突检测与命令生成的数量。
+// 按键（Button）与触摸按下/抬起事件总是原样保留。
+// 只合并一段连续的非零更新：值为 0 的事件（如方向松开）原样保留并结束这一段，
+// 任何边沿事件（按键、触摸按下/抬起）都结束当前所有的段，更新不会跨过边沿移动。
+// 保留下来的事件留在原位置（KeepLatest / AccumulateDelta 为该段最后一次出现处），
+// 因此整体仍按时间戳有序，下游看到的按下/松开与边沿顺序和合并前相同。
+class EventCoalescer {
+public:
+    // 按事件类型设置默认策略（默认全部为 None）
+    void setDefaultPolicy(EventType type, CoalescePolicy policy) {
+        defaults[static_cast<size_t>(type)] = policy;
+    }
+
+    // 为特定 (设备, 输入码, 事件类型) 单独设置策略
+    void setPolicy(DeviceType device, int code, EventType type, CoalescePolicy policy) {
+        overrides[makeKey(device, code, type)] = policy;
+    }
+
+    CoalescePolicy policyFor(const DeviceEvent& event) const {
+        return policyFor(event.device, event.code, event.type);
+    }
+    CoalescePolicy policyFor(DeviceType device, int code, EventType type) const;
+
+    // 原地合并一帧事件，返回合并后的事件数
+    size_t coalesce(std::vector<DeviceEvent>& events);
+
+    // 批量形式：只读写 device/type/code/instanceId/pointerId/value 与 keep 列，被合并的事件
+    // 把 keep 置 0（不搬移数据），已被前面阶段丢弃的事件不参与合并。返回保留的事件数
+    size_t coalesce(EventBatch& batch);
+
+    size_t lastInputCount() const { return inputCount; }
+    size_t lastOutputCount() const { return outputCount; }
+
+private:
+    struct Group {
+        uint64_t key = 0;
+        uint16_t instance = 0; // 设备实例编号（key 的 64 位已被占满，单独比较）
+        uint32_t generation = 0;
+        uint32_t lastIndex = 0;
+        uint32_t minIndex = 0;
+        uint32_t maxIndex = 0;
+        float accumulated = 0.0f;
+        bool open = false; // 为 false 时下一次非零更新开始新的一段
+    };
+
+    static uint64_t makeKey(DeviceType device, int code, EventType type) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(device)) << 40) |
+               (static_cast<uint64_t>(static_cast<uint32_t>(type)) << 32) |
+               static_cast<uint32_t>(code);
+    }
+
+    // 分组键（与 Group::instance 一起）：同类设备的多个实例、多点触摸的各触点分别合并
+    static uint64_t groupKey(DeviceType device, int code, EventType type, uint16_t pointerId) {
+        return makeKey(device, code, type) ^ (static_cast<uint64_t>(pointerId) << 48);
+    }
+
+    static bool isEdgeEvent(EventType type) {
+        return type == EventType::Button || type == EventType::TouchDown || type == EventType::TouchUp;
+    }
+
+    Group& findGroup(uint64_t key, uint16_t instance, bool& created);
+
+    // 为 n 个事件准备分组表并开始新的一代
+    void beginFrame(size_t n);
+    // 开始新的一代：之前的分组全部失效
+    void nextGeneration();
+
+    // 合并核心：Rows 提供按下标访问的 device/type/code/instanceId/pointerId/value，
+    // AoS 与 SoA 两种形式共用。把被合并的事件在 keep 中置 0，返回是否有合并
+    template <typename Rows>
+    bool markMerged(Rows& rows, size_t n, uint8_t* keep);
+
+    CoalescePolicy defaults[kEventTypeCount] = {};
+    std::unordered_map<uint64_t, CoalescePolicy> overrides;
+
+    // 以下为帧间复用的临时空间
+    std::vector<Group> groups;
+    size_t groupMask = 0;
+    uint32_t generation = 0;
+    std::vector<uint8_t> keep;
+    size_t inputCount = 0;
+    size_t outputCount = 0;
+};
+
+#endif // EVENT_COALESCER_H
@@ -0,0 +1,89 @@
+#ifndef EVENT_MERGE_H
+#define EVENT_MERGE_H
+
+#include "DeviceEvent.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 一段按时间戳有序的事件（通常来自同一个适配器）
+struct EventRun {
+    const DeviceEvent* begin = nullptr;
+    const DeviceEvent* end = nullptr;
+    uint32_t order = 0;  // 时间戳与设备优先级都相同时按此顺序（如注册顺序）
+};
+
+// 事件排序键：时间戳升序；时间戳相同时 devicePriority[device] 较大的设备在前
+// （devicePriority 为空时只比较时间戳）
+inline bool eventBefore(const DeviceEvent& a, const DeviceEvent& b, const int* devicePriority) {
+    if (a.timestamp != b.timestamp) return a.timestamp < b.timestamp;
+    return devicePriority &&
+           devicePriority[static_cast<size_t>(a.device)] > devicePriority[static_cast<size_t>(b.device)];
+}
+
+// 对几乎有序的事件段做原地插入排序（已有序时为 O(n)，不分配内存，稳定）。
+// 混有多种设备的段（如输入流）应传入 devicePriority，与多路归并的并列规则保持一致
+inline void sortEventRun(DeviceEvent* first, DeviceEvent* last, const int* devicePriority = nullptr) {
+    for (DeviceEvent* it = first + 1; it < last; ++it) {
+        if (!eventBefore(*it, *(it - 1), devicePriority)) continue;
+        DeviceEvent value = *it;
+        DeviceEvent* hole = it;
+        while (hole > first && eventBefore(value, *(hole - 1), devicePriority)) {
+            *hole = *(hole - 1);
+            --hole;
+        }
+        *hole = value;
+    }
+}
+
+// 多路归并：把 k 段有序事件合并为一条严格按时间戳排序的流，复杂度 O(n log k)
+// 堆空间在多次调用之间复用，稳态下不分配内存
+// 时间戳相同时，devicePriority[device] 较大的设备在前
+class EventMerger {
+public:
+    template <typename Emit>
+    void merge(const EventRun* runs, size_t runCount, const int* devicePriority, Emit&& emit) {
+        heap.clear();
+        for (size_t i = 0; i < runCount; ++i) {
+            if (runs[i].begin != runs[i].end) {
+                heap.push_back(Cursor{runs[i].begin, runs[i].end, runs[i].order});
+            }
+        }
+        const Later later{devicePriority};
+        std::make_heap(heap.begin(), heap.end(), later);
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            Cursor& cursor = heap.back();
+            emit(*cursor.next);
+            if (++cursor.next == cursor.end) {
+                heap.pop_back();
+            } else {
+                std::push_heap(heap.begin(), heap.end(), later);
+            }
+        }
+    }
+
+private:
+    struct Cursor {
+        const DeviceEvent* next;
+        const DeviceEvent* end;
+        uint32_t order;
+    };
+
+    // 小顶堆比较器：a 是否应排在 b 之后
+    struct Later {
+        const int* devicePriority;
+        bool operator()(const Cursor& a, const Cursor& b) const {
+            if (a.next->timestamp != b.next->timestamp) return a.next->timestamp > b.next->timestamp;
+            int pa = devicePriority[static_cast<size_t>(a.next->device)];
+            int pb = devicePriority[static_cast<size_t>(b.next->device)];
+            if (pa != pb) return pa < pb;
+            return a.order > b.order;
+        }
+    };
+
+    std::vector<Cursor> heap;
+};
+
+#endif // EVENT_MERGE_H
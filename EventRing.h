@@ -0,0 +1,160 @@
+#ifndef EVENT_RING_H
+#define EVENT_RING_H
+
+#include "DeviceEvent.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// 队列满时的处理策略
+enum class OverflowPolicy {
+    DropOldest,     // 丢弃最旧的事件，为新事件腾出位置
+    DropNewest,     // 丢弃新到达的事件
+    CountAndReport  // 拒绝新事件，计数并由消费者读取上报
+};
+
+// 有界无锁多生产者单消费者事件环形队列（输入流层）
+// 基于每个槽位序号的设计：生产者之间只在 tail 上竞争，消费者从不阻塞生产者，
+// 构造后不再进行任何内存分配。容量会向上取整为 2 的幂。
+class EventRing {
+public:
+    explicit EventRing(size_t capacity = 4096,
+                       OverflowPolicy policy = OverflowPolicy::DropOldest)
+        : mask(roundUpPow2(capacity) - 1),
+          cells(new Cell[mask + 1]),
+          overflowPolicy(policy) {
+        for (size_t i = 0; i <= mask; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    EventRing(const EventRing&) = delete;
+    EventRing& operator=(const EventRing&) = delete;
+
+    // 生产者接口，可在任意线程调用。返回事件是否入队
+    bool push(const DeviceEvent& event) {
+        for (;;) {
+            if (tryPush(event)) {
+                return true;
+            }
+            switch (policy()) {
+                case OverflowPolicy::DropOldest: {
+                    // 由生产者淘汰队首，再重试入队
+                    DeviceEvent discarded;
+                    if (tryPop(discarded)) {
+                        dropped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    continue;
+                }
+                case OverflowPolicy::DropNewest:
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                case OverflowPolicy::CountAndReport:
+                    overflows.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+            }
+        }
+    }
+
+    // 消费者接口：取出一个事件，队列为空时立即返回 false
+    bool pop(DeviceEvent& out) { return tryPop(out); }
+
+    // 消费者接口：把当前所有事件交给 fn，返回取出的数量
+    template <typename Fn>
+    size_t drain(Fn&& fn) {
+        size_t count = 0;
+        DeviceEvent event;
+        while (tryPop(event)) {
+            fn(event);
+            ++count;
+        }
+        return count;
+    }
+
+    void setOverflowPolicy(OverflowPolicy p) {
+        overflowPolicy.store(p, std::memory_order_relaxed);
+    }
+    OverflowPolicy policy() const {
+        return overflowPolicy.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // 近似的当前长度（并发下仅供统计）
+    size_t sizeApprox() const {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_relaxed);
+        return t > h ? t - h : 0;
+    }
+
+    // 因溢出被丢弃的事件总数（DropOldest / DropNewest）
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    // CountAndReport 策略下，自上次调用以来被拒绝的事件数
+    uint64_t takeOverflowReport() { return overflows.exchange(0, std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        DeviceEvent event;
+    };
+
+    static size_t roundUpPow2(size_t v) {
+        size_t p = 2;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    bool tryPush(const DeviceEvent& event) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.event = event;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // 已满
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // DropOldest 策略下生产者也会出队，因此 head 同样使用 CAS 推进
+    bool tryPop(DeviceEvent& out) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = cell.event;
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // 为空
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<OverflowPolicy> overflowPolicy;
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> overflows{0};
+};
+
+#endif // EVENT_RING_H
@@ -1,30 +1,47 @@
 #include "GamepadAdapter.h"
-#include <chrono>
-#include <random>
+#include "InputClock.h"
 
 // 示例实现：无真输入，仅模拟空事件
-std::vector<DeviceEvent> GamepadAdapter::pollEvents() {
-    std::vector<DeviceEvent> events;
-    if (!enabled) return events;
+void GamepadAdapter::pollInto(EventSink& sink) {
+    if (!enabled) return;
     
-    static uint64_t lastEventTime = 0;
-    static bool isMoving = false;
-    static bool isTouching = false;
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(800, 2500); // 随机间隔800-2500ms
-    
-    uint64_t currentTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
-    ).count();
+    uint64_t currentTime = inputNowNanos();
+
+    if (stroking) {
+        if (currentTime - lastMoveTime < 4 * kNanosPerMilli) return;
+        DeviceEvent event{};
+        event.device = DeviceType::Touch;
+        event.instanceId = static_cast<uint16_t>(instanceId());
+        event.timestamp = currentTime;
+        event.pointerId = strokePointer;
+        strokeX += strokeDx;
+        strokeY += strokeDy;
+        event.x = strokeX;
+        event.y = strokeY;
+        if (currentTime - strokeStart >= 150 * kNanosPerMilli) {
+            event.type = EventType::TouchUp;
+            event.code = 2002;
+            event.value = 0.0f;
+            stroking = false;
+            lastEventTime = currentTime;
+        } else {
+            event.type = EventType::TouchMove;
+            event.code = 2003;
+            event.value = 1.0f;
+        }
+        sink.push(event);
+        lastMoveTime = currentTime;
+        return;
+    }
     
     // 模拟玩家操作模式：跳跃、攻击、移动、触摸
-    if (currentTime - lastEventTime >= dis(gen)) {
+    if (currentTime - lastEventTime >= dis(gen) * kNanosPerMilli) {
         // 随机选择一个动作
         int action = dis(gen) % 6; // 0:Jump, 1:Attack, 2:MoveForward, 3:MoveBackward, 4:TouchDown, 5:TouchUp
         
-        DeviceEvent event;
+        DeviceEvent event{};
         event.device = DeviceType::Touch;
+        event.instanceId = static_cast<uint16_t>(instanceId());
         event.timestamp = currentTime;
         
         switch (action) {
@@ -50,23 +67,31 @@ std::vector<DeviceEvent> GamepadAdapter::pollEvents() {
                 event.value = isMoving ? 0.0f : 1.0f;
                 isMoving = !isMoving;
                 break;
-            case 4: // TouchDown
+            case 4: // TouchDown，随后向随机方向滑动（每 4ms 移动 0.008，约 2 屏/秒）
                 event.type = EventType::TouchDown;
                 event.code = 2001;
                 event.value = 1.0f;
-                isTouching = true;
+                event.pointerId = ++strokePointer;
+                event.x = strokeX = 0.5f;
+                event.y = strokeY = 0.5f;
+                strokeDx = strokeDy = 0.0f;
+                switch (dis(gen) % 4) {
+                    case 0: strokeDx = -0.008f; break;
+                    case 1: strokeDx = 0.008f; break;
+                    case 2: strokeDy = -0.008f; break;
+                    default: strokeDy = 0.008f; break;
+                }
+                strokeStart = lastMoveTime = currentTime;
+                stroking = true;
                 break;
             case 5: // TouchUp
                 event.type = EventType::TouchUp;
                 event.code = 2002;
                 event.value = 0.0f;
-                isTouching = false;
                 break;
         }
         
-        events.push_back(event);
+        sink.push(event);
         lastEventTime = currentTime;
     }
-    
-    return events;
 }
\ No newline at end of file
@@ -2,11 +2,28 @@
 #define GAMEPAD_ADAPTER_H
 
 #include "IDeviceAdapter.h"
+#include <cstdint>
+#include <random>
 
-// 手柄适配器（示例）
+// 手柄适配器（示例）：模拟的是屏幕上的虚拟手柄，产生的都是触屏事件。
+// 模拟状态按实例保存，指定 seed 时输出可复现
 class GamepadAdapter : public IDeviceAdapter {
 public:
-    std::vector<DeviceEvent> pollEvents() override;
+    explicit GamepadAdapter(uint32_t instanceId = 0, uint32_t seed = std::random_device{}())
+        : IDeviceAdapter(DeviceType::Touch, instanceId), gen(seed) {}
+
+    void pollInto(EventSink& sink) override;
+
+private:
+    uint64_t lastEventTime = 0;
+    bool isMoving = false;
+    std::mt19937 gen;
+    std::uniform_int_distribution<> dis{800, 2500}; // 随机间隔800-2500ms
+    // 正在进行的滑动：约 240Hz 输出 TouchMove，持续 150ms 后抬起
+    bool stroking = false;
+    uint16_t strokePointer = 0;
+    float strokeX = 0.0f, strokeY = 0.0f, strokeDx = 0.0f, strokeDy = 0.0f;
+    uint64_t strokeStart = 0, lastMoveTime = 0;
 };
 
 #endif // GAMEPAD_ADAPTER_H
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "GestureRecognizer.h"
+#include <cmath>
+
+float GestureRecognizer::distance(const Sample& a, const Sample& b) {
+    return std::hypot(a.x - b.x, a.y - b.y);
+}
+
+GestureRecognizer::Pointer* GestureRecognizer::find(uint16_t id) {
+    for (Pointer& pointer : pointers) {
+        if (pointer.active && pointer.id == id) return &pointer;
+    }
+    return nullptr;
+}
+
+void GestureRecognizer::onDown(const DeviceEvent& event) {
+    // 同一触点重复按下时复用原槽位
+    Pointer* pointer = find(event.pointerId);
+    if (!pointer) {
+        for (Pointer& slot : pointers) {
+            if (!slot.active) {
+                pointer = &slot;
+                break;
+            }
+        }
+    }
+    if (!pointer) {
+        ++dropped;
+        return;
+    }
+    const size_t slot = static_cast<size_t>(pointer - pointers);
+    if (slot == pinchA || slot == pinchB) endPinch();
+
+    *pointer = Pointer{};
+    pointer->active = true;
+    pointer->id = event.pointerId;
+    pointer->down = sampleOf(event);
+    pointer->push(pointer->down);
+
+    // 已有一个触点按着（且未在长按或缩放中）时，第二个触点开始两指缩放
+    if (pinchA != kNoSlot) return;
+    for (size_t other = 0; other < kMaxPointers; ++other) {
+        Pointer& first = pointers[other];
+        if (other == slot || !first.active || first.pinching || first.longPressed) continue;
+        pinchA = other;
+        pinchB = slot;
+        first.pinching = true;
+        pointer->pinching = true;
+        pinchBase = distance(first.latest(), pointer->latest());
+        break;
+    }
+}
+
+void GestureRecognizer::endPinch() {
+    // 触点的 pinching 标记保留到抬起，本次触摸不再识别为滑动或长按
+    pinchA = kNoSlot;
+    pinchB = kNoSlot;
+    pinchBase = 0.0f;
+}
+
+float GestureRecognizer::releaseSpeed(const Pointer& pointer) const {
+    const Sample& last = pointer.latest();
+    // 从最新的采样往回找，取速度窗口内最早的一个
+    const Sample* first = &last;
+    for (uint32_t i = 1; i < pointer.count; ++i) {
+        const Sample& sample = pointer.history[(pointer.head + kHistorySize - 1 - i) % kHistorySize];
+        if (last.timestamp - sample.timestamp > settings.velocityWindowNanos) break;
+        first = &sample;
+    }
+    if (first == &last || last.timestamp <= first->timestamp) {
+        // 窗口内只有一个采样：退化为整个触摸过程的平均速度
+        first = &pointer.down;
+        if (last.timestamp <= first->timestamp) return 0.0f;
+    }
+    const double seconds = static_cast<double>(last.timestamp - first->timestamp) * 1e-9;
+    return static_cast<float>(distance(last, *first) / seconds);
+}
+
+size_t GestureRecognizer::recognize(std::vector<DeviceEvent>& events, uint64_t now) {
+    // 先记录手势及其插入位置；没有识别出手势时不改动事件序列
+    pending.clear();
+    for (size_t i = 0; i < events.size(); ++i) {
+        feed(events[i], [&](const DeviceEvent& gesture) { pending.push_back(PendingGesture{i + 1, gesture}); });
+    }
+    advance(now, [&](const DeviceEvent& gesture) { pending.push_back(PendingGesture{events.size(), gesture}); });
+    if (pending.empty()) return 0;
+
+    output.clear();
+    size_t next = 0;
+    for (const PendingGesture& gesture : pending) {
+        output.insert(output.end(), events.begin() + next, events.begin() + gesture.position);
+        output.push_back(gesture.event);
+        next = gesture.position;
+    }
+    output.insert(output.end(), events.begin() + next, events.end());
+    // 交换缓冲：两个 vector 的容量都在帧间保留
+    events.swap(output);
+    return pending.size();
+}
+
+void GestureRecognizer::reset() {
+    for (Pointer& pointer : pointers) pointer = Pointer{};
+    endPinch();
+    dropped = 0;
+}
+
+size_t GestureRecognizer::activePointers() const {
+    size_t count = 0;
+    for (const Pointer& pointer : pointers) count += pointer.active ? 1 : 0;
+    return count;
+}
@@ -0,0 +1,261 @@
+#ifndef GESTURE_RECOGNIZER_H
+#define GESTURE_RECOGNIZER_H
+
+#include "DeviceEvent.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 手势种类
+enum class GestureType : uint8_t {
+    SwipeLeft,
+    SwipeRight,
+    SwipeUp,
+    SwipeDown,
+    PinchIn,
+    PinchOut,
+    LongPress
+};
+
+constexpr size_t kGestureTypeCount = 7;
+
+// 手势以 DeviceType::Touch 的 Button 事件发出，输入码从 kGestureCodeBase 起依次编号，
+// 在 bindings.json 中像普通按键一样绑定动作（3001 = SwipeLeft ... 3007 = LongPress）
+constexpr int kGestureCodeBase = 3001;
+
+inline int gestureCode(GestureType type) { return kGestureCodeBase + static_cast<int>(type); }
+
+// 将手势种类转换为字符串
+inline const char* gestureTypeToString(GestureType type) {
+    switch (type) {
+        case GestureType::SwipeLeft:
+            return "SwipeLeft";
+        case GestureType::SwipeRight:
+            return "SwipeRight";
+        case GestureType::SwipeUp:
+            return "SwipeUp";
+        case GestureType::SwipeDown:
+            return "SwipeDown";
+        case GestureType::PinchIn:
+            return "PinchIn";
+        case GestureType::PinchOut:
+            return "PinchOut";
+        case GestureType::LongPress:
+            return "LongPress";
+        default:
+            return "Unknown";
+    }
+}
+
+// 识别参数（距离为归一化屏幕坐标）
+struct GestureConfig {
+    float swipeMinDistance = 0.15f;  // 滑动：按下到抬起的最小位移
+    float swipeMinVelocity = 0.8f;   // 滑动：抬起前 velocityWindow 内的最小速度（每秒）
+    uint64_t swipeMaxNanos = 400 * 1000000ull; // 滑动：按下到抬起的最长时间
+    uint64_t velocityWindowNanos = 50 * 1000000ull;
+    float pinchStep = 0.2f;          // 缩放：两指距离相对变化超过此比例时发出一次
+    uint64_t longPressNanos = 500 * 1000000ull; // 长按：保持静止的时间
+    float touchSlop = 0.03f;         // 移动不超过此距离视为静止
+};
+
+// 流式多点触摸手势识别：滑动、两指缩放、长按。
+//
+// 每个触点占用一个定长槽位（最多 kMaxPointers 个），槽位内用定长环形缓冲保存
+// 最近 kHistorySize 个采样，用于计算抬起前的速度，因此 240Hz 以上的触摸流
+// 也只占用固定内存。超出槽位数的触点被忽略并计数。
+//
+// 识别结果作为 Touch Button 事件插入到触发它的事件之后：滑动与缩放是一次按下 + 松开，
+// 长按在识别时按下、手指抬起时松开（可以作为"按住"使用）。原始触摸事件保持不变。
+class GestureRecognizer {
+public:
+    static constexpr size_t kMaxPointers = 10;
+    static constexpr size_t kHistorySize = 32;
+
+    void setConfig(const GestureConfig& cfg) { settings = cfg; }
+    const GestureConfig& config() const { return settings; }
+
+    // 处理一帧事件，把识别出的手势事件插入其中，返回插入的事件数。
+    // now 为当前时刻，用于在没有新触摸事件时判定长按
+    size_t recognize(std::vector<DeviceEvent>& events, uint64_t now);
+
+    // 逐个事件处理；识别出手势时调用 emit(const DeviceEvent&)
+    template <typename Emit>
+    void feed(const DeviceEvent& event, Emit&& emit) {
+        if (event.device != DeviceType::Touch) return;
+        switch (event.type) {
+            case EventType::TouchDown:
+                onDown(event);
+                break;
+            case EventType::TouchMove:
+                onMove(event, emit);
+                break;
+            case EventType::TouchUp:
+                onUp(event, emit);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // 推进时间：检查静止的触点是否达到长按时间
+    template <typename Emit>
+    void advance(uint64_t now, Emit&& emit) {
+        for (Pointer& pointer : pointers) {
+            if (pointer.active) checkLongPress(pointer, now, emit);
+        }
+    }
+
+    void reset();
+
+    size_t activePointers() const;
+    uint64_t droppedPointers() const { return dropped; }
+
+private:
+    struct Sample {
+        float x = 0.0f;
+        float y = 0.0f;
+        uint64_t timestamp = 0;
+    };
+
+    struct Pointer {
+        bool active = false;
+        bool moved = false;       // 移动超过 touchSlop
+        bool longPressed = false; // 已发出长按（抬起时发出松开）
+        bool pinching = false;    // 参与缩放的触点不再识别滑动与长按
+        uint16_t id = 0;
+        Sample down;
+        Sample history[kHistorySize];
+        uint32_t head = 0;  // 下一个写入位置
+        uint32_t count = 0;
+
+        const Sample& latest() const { return history[(head + kHistorySize - 1) % kHistorySize]; }
+        void push(const Sample& sample) {
+            history[head] = sample;
+            head = (head + 1) % kHistorySize;
+            if (count < kHistorySize) ++count;
+        }
+    };
+
+    static Sample sampleOf(const DeviceEvent& event) { return Sample{event.x, event.y, event.timestamp}; }
+    static float distance(const Sample& a, const Sample& b);
+
+    static DeviceEvent gestureEvent(GestureType type, float value, const Pointer& pointer, uint64_t timestamp) {
+        DeviceEvent event{};
+        event.device = DeviceType::Touch;
+        event.type = EventType::Button;
+        event.code = gestureCode(type);
+        event.value = value;
+        event.pointerId = pointer.id;
+        event.x = pointer.latest().x;
+        event.y = pointer.latest().y;
+        event.timestamp = timestamp;
+        return event;
+    }
+
+    // 瞬时手势：同一时刻按下并松开
+    template <typename Emit>
+    static void emitTap(GestureType type, float value, const Pointer& pointer, uint64_t timestamp, Emit& emit) {
+        emit(gestureEvent(type, value, pointer, timestamp));
+        emit(gestureEvent(type, 0.0f, pointer, timestamp));
+    }
+
+    Pointer* find(uint16_t id);
+
+    void onDown(const DeviceEvent& event);
+
+    template <typename Emit>
+    void onMove(const DeviceEvent& event, Emit& emit) {
+        Pointer* pointer = find(event.pointerId);
+        if (!pointer) return;
+        const Sample sample = sampleOf(event);
+        pointer->push(sample);
+        if (!pointer->moved && distance(sample, pointer->down) > settings.touchSlop) {
+            pointer->moved = true;
+        }
+        if (pointer->pinching) {
+            updatePinch(event.timestamp, emit);
+        } else {
+            checkLongPress(*pointer, event.timestamp, emit);
+        }
+    }
+
+    template <typename Emit>
+    void onUp(const DeviceEvent& event, Emit& emit) {
+        Pointer* pointer = find(event.pointerId);
+        if (!pointer) return;
+        pointer->push(sampleOf(event));
+
+        if (pointer->longPressed) {
+            emit(gestureEvent(GestureType::LongPress, 0.0f, *pointer, event.timestamp));
+        } else if (!pointer->pinching) {
+            checkSwipe(*pointer, event.timestamp, emit);
+        }
+        pointer->active = false;
+        if (pointer->pinching) {
+            endPinch();
+        }
+    }
+
+    template <typename Emit>
+    void checkLongPress(Pointer& pointer, uint64_t now, Emit& emit) {
+        if (pointer.longPressed || pointer.moved || pointer.pinching) return;
+        if (now < pointer.down.timestamp || now - pointer.down.timestamp < settings.longPressNanos) return;
+        pointer.longPressed = true;
+        emit(gestureEvent(GestureType::LongPress, 1.0f, pointer, pointer.down.timestamp + settings.longPressNanos));
+    }
+
+    template <typename Emit>
+    void checkSwipe(const Pointer& pointer, uint64_t upTime, Emit& emit) {
+        if (upTime < pointer.down.timestamp || upTime - pointer.down.timestamp > settings.swipeMaxNanos) return;
+        const Sample& last = pointer.latest();
+        const float dx = last.x - pointer.down.x;
+        const float dy = last.y - pointer.down.y;
+        if (dx * dx + dy * dy < settings.swipeMinDistance * settings.swipeMinDistance) return;
+
+        const float speed = releaseSpeed(pointer);
+        if (speed < settings.swipeMinVelocity) return;
+
+        GestureType type;
+        if (dx * dx >= dy * dy) type = dx < 0.0f ? GestureType::SwipeLeft : GestureType::SwipeRight;
+        else type = dy < 0.0f ? GestureType::SwipeUp : GestureType::SwipeDown;
+        emitTap(type, speed, pointer, upTime, emit);
+    }
+
+    // 抬起前 velocityWindow 内的平均速度（每秒）
+    float releaseSpeed(const Pointer& pointer) const;
+
+    void endPinch();
+
+    template <typename Emit>
+    void updatePinch(uint64_t timestamp, Emit& emit) {
+        if (pinchA == kNoSlot || pinchBase <= 0.0f) return;
+        const float current = distance(pointers[pinchA].latest(), pointers[pinchB].latest());
+        const float ratio = current / pinchBase;
+        if (ratio >= 1.0f + settings.pinchStep) {
+            emitTap(GestureType::PinchOut, ratio, pointers[pinchB], timestamp, emit);
+            pinchBase = current;
+        } else if (ratio * (1.0f + settings.pinchStep) <= 1.0f) {
+            emitTap(GestureType::PinchIn, ratio, pointers[pinchB], timestamp, emit);
+            pinchBase = current;
+        }
+    }
+
+    static constexpr size_t kNoSlot = kMaxPointers;
+
+    GestureConfig settings;
+    Pointer pointers[kMaxPointers];
+    size_t pinchA = kNoSlot; // 参与缩放的两个槽位
+    size_t pinchB = kNoSlot;
+    float pinchBase = 0.0f;  // 上一次发出缩放时的两指距离
+    uint64_t dropped = 0;
+
+    // recognize() 帧间复用的缓冲
+    struct PendingGesture {
+        size_t position; // 插入到原事件序列的该位置之前
+        DeviceEvent event;
+    };
+    std::vector<PendingGesture> pending;
+    std::vector<DeviceEvent> output;
+};
+
+#endif // GESTURE_RECOGNIZER_H
@@ -2,20 +2,62 @@
 #define IDEVICE_ADAPTER_H
 
 #include "DeviceEvent.h"
+#include <atomic>
+#include <cstdint>
 #include <vector>
 
+// 事件接收端：缓冲区由调用方持有，适配器直接写入，避免每帧分配
+class EventSink {
+public:
+    virtual ~EventSink() = default;
+    virtual void push(const DeviceEvent& event) = 0;
+};
+
+// 写入调用方复用的 vector（容量在帧间保留，稳态下不再分配）
+class VectorEventSink : public EventSink {
+public:
+    explicit VectorEventSink(std::vector<DeviceEvent>& out) : out(out) {}
+    void push(const DeviceEvent& event) override { out.push_back(event); }
+
+private:
+    std::vector<DeviceEvent>& out;
+};
+
 // 设备适配器接口：将原生事件转换为 DeviceEvent
 class IDeviceAdapter {
 public:
+    // 只产生一种设备事件的适配器声明其类型与实例编号（例如第几个手柄），
+    // DeviceManager 据此分桶，enableDevice 只作用于对应类型的适配器
+    explicit IDeviceAdapter(DeviceType type, uint32_t instanceId = 0)
+        : type(type), instance(instanceId), typed(true) {}
+    // 事件来自多种设备的适配器（如回放）不声明类型，不受 enableDevice 影响
+    IDeviceAdapter() = default;
     virtual ~IDeviceAdapter() = default;
-    // 拉取本帧所有事件
-    virtual std::vector<DeviceEvent> pollEvents() = 0;
-    // 启用／禁用该适配器
-    virtual void enable(bool on) { enabled = on; }
-    virtual bool isEnabled() const { return enabled; }
+
+    bool hasDeviceType() const { return typed; }
+    DeviceType deviceType() const { return type; }
+    uint32_t instanceId() const { return instance; }
+
+    // 拉取本帧所有事件，写入 sink
+    virtual void pollInto(EventSink& sink) = 0;
+    // 兼容接口：每次调用都会分配一个新的 vector，热路径请使用 pollInto
+    virtual std::vector<DeviceEvent> pollEvents() {
+        std::vector<DeviceEvent> events;
+        VectorEventSink sink(events);
+        pollInto(sink);
+        return events;
+    }
+    // 启用／禁用该适配器（可在任意线程调用，轮询线程无锁读取）
+    virtual void enable(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    virtual bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
 
 protected:
-    bool enabled = true;
+    std::atomic<bool> enabled{true};
+
+private:
+    DeviceType type = DeviceType::Keyboard;
+    uint32_t instance = 0;
+    bool typed = false;
 };
 
-#endif // IDEVICE_ADAPTER_H
\ No newline at end of file
+#endif // IDEVICE_ADAPTER_H
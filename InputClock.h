@@ -0,0 +1,16 @@
+#ifndef INPUT_CLOCK_H
+#define INPUT_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+// 输入系统统一使用的单调时钟（纳秒），不受系统时间调整影响
+inline uint64_t inputNowNanos() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+constexpr uint64_t kNanosPerMicro = 1000ULL;
+constexpr uint64_t kNanosPerMilli = 1000ULL * kNanosPerMicro;
+
+#endif // INPUT_CLOCK_H
@@ -0,0 +1,33 @@
+#include "InputHistory.h"
+
+InputHistory::InputHistory(size_t frameCapacity) : slots(frameCapacity ? frameCapacity : 1) {}
+
+uint64_t InputHistory::process(InputProcessor& processor, const std::vector<DeviceEvent>& events) {
+    const uint64_t frame = processor.getActionState().pending().frameNumber;
+    if (count != 0 && frame != latest + 1) count = 0;
+
+    Slot& entry = slot(frame);
+    processor.saveState(entry.state);
+    entry.events.assign(events.begin(), events.end());
+    latest = frame;
+    if (count < slots.size()) ++count;
+
+    processor.processInput(entry.events);
+    return frame;
+}
+
+const InputFrameState* InputHistory::state(uint64_t frame) const {
+    return contains(frame) ? &slot(frame).state : nullptr;
+}
+
+std::vector<DeviceEvent>* InputHistory::events(uint64_t frame) {
+    return contains(frame) ? &slot(frame).events : nullptr;
+}
+
+bool InputHistory::rewind(InputProcessor& processor, uint64_t frame) {
+    if (!contains(frame)) return false;
+    processor.restoreState(slot(frame).state);
+    count -= static_cast<size_t>(latest - frame + 1);
+    latest = frame - 1;
+    return true;
+}
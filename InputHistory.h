@@ -0,0 +1,78 @@
+#ifndef INPUT_HISTORY_H
+#define INPUT_HISTORY_H
+
+#include "DeviceEvent.h"
+#include "InputProcessor.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 按帧号索引的输入历史环（回滚同步、回放拖动）：每帧保存处理前的 InputFrameState
+// 和送入 InputProcessor 的事件。保存/恢复都是一次定长 POD 拷贝，与回滚的帧数无关；
+// 事件数组复用容量，稳定后不再分配内存。
+//
+// 帧号即 ActionFrame::frameNumber（正在构建的帧）。重新模拟使用当前的绑定表，
+// 热重载之后回滚到更早的帧，结果按新绑定表计算。
+class InputHistory {
+public:
+    explicit InputHistory(size_t frameCapacity = 128);
+
+    // 保存当前状态与本帧事件，再把事件作为一帧交给 processor 处理（含 endFrame），返回帧号。
+    // 帧号与历史不连续时（例如在外部调用过 endFrame）先清空历史
+    uint64_t process(InputProcessor& processor, const std::vector<DeviceEvent>& events);
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    size_t capacity() const { return slots.size(); }
+
+    // 可回滚的帧范围 [oldestFrame, latestFrame]（历史为空时无意义）
+    uint64_t oldestFrame() const { return latest + 1 - count; }
+    uint64_t latestFrame() const { return latest; }
+    bool contains(uint64_t frame) const { return count != 0 && frame <= latest && frame >= oldestFrame(); }
+
+    // 某帧开始时的状态与该帧的事件（不在历史中时返回空）。
+    // 事件可以修改，例如替换为迟到的远端输入后再 resimulate
+    const InputFrameState* state(uint64_t frame) const;
+    std::vector<DeviceEvent>* events(uint64_t frame);
+
+    // 把 processor 恢复到 frame 开始时的状态，并丢弃 frame 及之后的历史
+    bool rewind(InputProcessor& processor, uint64_t frame);
+
+    // 回到 frame 开始时的状态，按序重新处理 frame..latestFrame 的事件并更新历史。
+    // 每帧处理前调用 edit(frameNumber, events)，可在此修正该帧的事件。
+    // 重新处理会再次执行命令回调；frame 不在历史中时返回 false
+    template <typename Edit>
+    bool resimulate(InputProcessor& processor, uint64_t frame, Edit&& edit) {
+        if (!contains(frame)) return false;
+        const uint64_t last = latest;
+        processor.restoreState(slot(frame).state);
+        for (uint64_t f = frame; f <= last; ++f) {
+            Slot& entry = slot(f);
+            if (f != frame) processor.saveState(entry.state);
+            edit(f, entry.events);
+            processor.processInput(entry.events);
+        }
+        return true;
+    }
+
+    bool resimulate(InputProcessor& processor, uint64_t frame) {
+        return resimulate(processor, frame, [](uint64_t, std::vector<DeviceEvent>&) {});
+    }
+
+    void clear() { count = 0; }
+
+private:
+    struct Slot {
+        InputFrameState state;
+        std::vector<DeviceEvent> events;
+    };
+
+    Slot& slot(uint64_t frame) { return slots[frame % slots.size()]; }
+    const Slot& slot(uint64_t frame) const { return slots[frame % slots.size()]; }
+
+    std::vector<Slot> slots;
+    uint64_t latest = 0;
+    size_t count = 0;
+};
+
+#endif // INPUT_HISTORY_H
@@ -0,0 +1,280 @@
+#include "InputLog.h"
+#include "ActionMap.h"
+#include "InputClock.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+
+const char* const kLevelNames[] = {"trace", "debug", "info", "warning", "error", "off"};
+
+} // namespace
+
+const char* logLevelToString(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace:
+            return "Trace";
+        case LogLevel::Debug:
+            return "Debug";
+        case LogLevel::Info:
+            return "Info";
+        case LogLevel::Warning:
+            return "Warning";
+        case LogLevel::Error:
+            return "Error";
+        case LogLevel::Off:
+            return "Off";
+        default:
+            return "Unknown";
+    }
+}
+
+const char* logCategoryToString(LogCategory category) {
+    switch (category) {
+        case LogCategory::General:
+            return "general";
+        case LogCategory::Input:
+            return "input";
+        case LogCategory::Action:
+            return "action";
+        case LogCategory::Bindings:
+            return "bindings";
+        case LogCategory::Device:
+            return "device";
+        default:
+            return "unknown";
+    }
+}
+
+bool parseLogLevel(const std::string& text, LogLevel& level) {
+    for (size_t i = 0; i < sizeof(kLevelNames) / sizeof(kLevelNames[0]); ++i) {
+        if (text == kLevelNames[i]) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+InputLog::InputLog() : out(&std::cout), err(&std::cerr), epoch(inputNowNanos()) {
+    for (auto& threshold : thresholds) {
+        threshold.store(static_cast<uint8_t>(LogLevel::Info), std::memory_order_relaxed);
+    }
+}
+
+InputLog::~InputLog() {
+    stop();
+}
+
+void InputLog::setLevel(LogLevel level) {
+    for (auto& threshold : thresholds) {
+        threshold.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+}
+
+void InputLog::setLevel(LogCategory category, LogLevel level) {
+    thresholds[static_cast<size_t>(category)].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+void InputLog::setOutput(std::ostream& outStream, std::ostream& errStream) {
+    std::lock_guard<std::mutex> lock(drainMutex);
+    out = &outStream;
+    err = &errStream;
+}
+
+void InputLog::start(uint32_t intervalMillis) {
+    if (worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = false;
+    }
+    active.store(true, std::memory_order_release);
+    worker = std::thread(&InputLog::run, this, intervalMillis ? intervalMillis : 1);
+}
+
+void InputLog::stop() {
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+    active.store(false, std::memory_order_release);
+    flush();
+}
+
+void InputLog::flush() {
+    std::lock_guard<std::mutex> lock(drainMutex);
+    drainLocked();
+}
+
+void InputLog::run(uint32_t intervalMillis) {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (!stopping) {
+        wake.wait_for(lock, std::chrono::milliseconds(intervalMillis));
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void InputLog::fillHeader(LogRecord& record, LogLevel level, LogCategory category, LogRecord::Kind kind,
+                          const char* format) {
+    record.timestamp = inputNowNanos();
+    record.format = format;
+    record.level = level;
+    record.category = category;
+    record.kind = kind;
+    record.length = 0;
+    record.actionCount = 0;
+    record.continued = 0;
+    record.reserved = 0;
+}
+
+void InputLog::writeMessage(LogLevel level, LogCategory category, const char* format, std::string_view detail) {
+    // 最多拆成 8 条记录，更长的部分截断
+    constexpr size_t kMaxParts = 8;
+    LogRecord parts[kMaxParts];
+    size_t count = 0;
+    do {
+        LogRecord& record = parts[count];
+        fillHeader(record, level, category, LogRecord::Text, format);
+        if (count > 0) record.timestamp = parts[0].timestamp;
+        const size_t length = std::min(detail.size(), LogRecord::kTextSize);
+        detail.copy(record.text, length);
+        record.length = static_cast<uint8_t>(length);
+        detail.remove_prefix(length);
+        ++count;
+        record.continued = (!detail.empty() && count < kMaxParts) ? 1 : 0;
+    } while (!detail.empty() && count < kMaxParts);
+    submit(parts, count);
+}
+
+void InputLog::submit(const LogRecord* records, size_t n) {
+    if (!active.load(std::memory_order_acquire)) {
+        // 没有后台线程：先输出环中已有的记录，再直接输出本条
+        std::lock_guard<std::mutex> lock(drainMutex);
+        drainLocked();
+        formatLocked(records, n);
+        writeLocked();
+        return;
+    }
+
+    ThreadRing& ring = rings.local();
+    const size_t t = ring.tail.load(std::memory_order_relaxed);
+    if (t + n - ring.cachedHead > kRingCapacity) {
+        ring.cachedHead = ring.head.load(std::memory_order_acquire);
+        if (t + n - ring.cachedHead > kRingCapacity) {
+            dropped.fetch_add(n, std::memory_order_relaxed);
+            return;
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        ring.slots[(t + i) & (kRingCapacity - 1)] = records[i];
+    }
+    ring.tail.store(t + n, std::memory_order_release);
+}
+
+void InputLog::drainLocked() {
+    ringList.clear();
+    rings.forEach([&](ThreadRing& ring) { ringList.push_back(&ring); });
+
+    batch.clear();
+    for (ThreadRing* ring : ringList) {
+        const size_t h = ring->head.load(std::memory_order_relaxed);
+        const size_t t = ring->tail.load(std::memory_order_acquire);
+        for (size_t i = h; i != t; ++i) {
+            batch.push_back(ring->slots[i & (kRingCapacity - 1)]);
+        }
+        ring->head.store(t, std::memory_order_release);
+    }
+    if (batch.empty()) return;
+
+    // 各线程的记录按写入时刻合并；同一时刻的接续记录保持相邻
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const LogRecord& a, const LogRecord& b) { return a.timestamp < b.timestamp; });
+    formatLocked(batch.data(), batch.size());
+    writeLocked();
+}
+
+void InputLog::formatLocked(const LogRecord* records, size_t n) {
+    // 只在需要解析动作名时获取绑定表快照
+    const bool needNames = std::any_of(records, records + n, [](const LogRecord& record) {
+        return record.kind == LogRecord::Event && record.actionCount > 0;
+    });
+    if (needNames) {
+        BindingSnapshot bindings = ActionMap::instance().snapshot();
+        formatLocked(records, n, &*bindings);
+    } else {
+        formatLocked(records, n, nullptr);
+    }
+}
+
+void InputLog::formatLocked(const LogRecord* records, size_t n, const BindingTable* bindings) {
+    char buffer[160];
+
+    for (size_t i = 0; i < n; ++i) {
+        const LogRecord& record = records[i];
+        std::string& text = record.level >= LogLevel::Warning ? errText : outText;
+
+        const double millis = static_cast<double>(record.timestamp - epoch) / kNanosPerMilli;
+        std::snprintf(buffer, sizeof(buffer), "[%10.3f] %-8s ", millis, logCategoryToString(record.category));
+        text += buffer;
+        if (record.level == LogLevel::Warning) text += "Warning: ";
+        else if (record.level == LogLevel::Error) text += "Error: ";
+        text += record.format ? record.format : "";
+
+        if (record.kind == LogRecord::Text) {
+            text.append(record.text, record.length);
+            while (records[i].continued && i + 1 < n) {
+                ++i;
+                text.append(records[i].text, records[i].length);
+            }
+            text += '\n';
+            continue;
+        }
+
+        if (bindings) {
+            for (size_t a = 0; a < record.actionCount; ++a) {
+                if (a > 0) text += ", ";
+                if (record.actions[a] < bindings->actionCount()) {
+                    text += bindings->action(record.actions[a]).name;
+                } else {
+                    text += "#" + std::to_string(record.actions[a]);
+                }
+            }
+        }
+        text.append(record.text, record.length);
+
+        const DeviceEvent& event = record.event;
+        text += " (";
+        text += deviceTypeToString(event.device);
+        text += ", ";
+        text += eventTypeToString(event.type);
+        std::snprintf(buffer, sizeof(buffer), ", 输入码 %d, 值 %g", event.code, static_cast<double>(event.value));
+        text += buffer;
+        if (event.device == DeviceType::Touch && event.type != EventType::Button) {
+            std::snprintf(buffer, sizeof(buffer), ", 触点 %u @ (%.3f, %.3f)", static_cast<unsigned>(event.pointerId),
+                          static_cast<double>(event.x), static_cast<double>(event.y));
+            text += buffer;
+        }
+        text += ")\n";
+    }
+}
+
+void InputLog::writeLocked() {
+    if (!outText.empty()) {
+        *out << outText;
+        out->flush();
+        outText.clear();
+    }
+    if (!errText.empty()) {
+        *err << errText;
+        err->flush();
+        errText.clear();
+    }
+}
@@ -0,0 +1,188 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include "BindingTable.h" // 用于 ActionId
+#include "DeviceEvent.h"
+#include "ThreadSlots.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// 日志级别
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+// 日志类别：每个类别单独设置级别
+enum class LogCategory : uint8_t {
+    General,
+    Input,    // 收到的设备事件
+    Action,   // 执行的动作命令
+    Bindings, // 绑定加载与热重载
+    Device    // 设备适配器
+};
+
+constexpr size_t kLogCategoryCount = 5;
+
+const char* logLevelToString(LogLevel level);
+const char* logCategoryToString(LogCategory category);
+
+// 解析级别名（trace/debug/info/warning/error/off），失败返回 false
+bool parseLogLevel(const std::string& text, LogLevel& level);
+
+// 定长二进制日志记录（128 字节）：写入方只做拷贝，格式化在后台线程进行。
+// format 必须是静态字符串（字面量），记录中只保存指针
+struct LogRecord {
+    static constexpr size_t kMaxActions = 4;
+    static constexpr size_t kTextSize = 48;
+
+    enum Kind : uint8_t {
+        Text,  // format + text
+        Event  // format + 动作名 + text + 事件
+    };
+
+    uint64_t timestamp;     // 写入时刻（inputNowNanos）
+    const char* format;
+    LogLevel level;
+    LogCategory category;
+    Kind kind;
+    uint8_t length;         // text 的有效字节数
+    uint8_t actionCount;
+    uint8_t continued;      // 文本未完，下一条记录接续（只有 text 有效）
+    uint16_t reserved;
+    ActionId actions[kMaxActions]; // 格式化时按当前绑定表解析为动作名
+    DeviceEvent event;
+    char text[kTextSize];
+};
+
+static_assert(sizeof(LogRecord) == 128, "LogRecord should stay two cache lines");
+
+// 异步日志：每个写入线程一个无锁环形缓冲（单生产者单消费者），后台线程成批取出、
+// 按时间排序后格式化输出，热路径上没有格式化、加锁与 flush。
+// 按类别设置级别；未开启的类别/级别只有一次原子读。
+// 环满时丢弃新记录并计数；start() 之前（或 stop() 之后）写入的记录在调用线程上直接输出。
+// Warning 及以上写入错误输出流，其余写入普通输出流。
+class InputLog {
+public:
+    static InputLog& instance() {
+        static InputLog instance;
+        return instance;
+    }
+
+    static constexpr size_t kRingCapacity = 4096; // 每个线程的记录数
+
+    InputLog(const InputLog&) = delete;
+    InputLog& operator=(const InputLog&) = delete;
+
+    bool enabled(LogCategory category, LogLevel level) const {
+        return static_cast<uint8_t>(level) >=
+               thresholds[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    // 设置所有类别 / 单个类别的最低输出级别（可在任意线程调用）
+    void setLevel(LogLevel level);
+    void setLevel(LogCategory category, LogLevel level);
+    LogLevel level(LogCategory category) const {
+        return static_cast<LogLevel>(thresholds[static_cast<size_t>(category)].load(std::memory_order_relaxed));
+    }
+
+    // 输出目标（默认 std::cout / std::cerr），应在 start() 之前设置
+    void setOutput(std::ostream& out, std::ostream& err);
+
+    // 启动后台线程，每 intervalMillis 毫秒（或有线程 flush 时）取出一次
+    void start(uint32_t intervalMillis = 10);
+    // 输出剩余记录并停止后台线程
+    void stop();
+    // 在调用线程上立即输出所有已写入的记录
+    void flush();
+
+    bool running() const { return worker.joinable(); }
+
+    // 因环满被丢弃的记录数
+    uint64_t droppedRecords() const { return dropped.load(std::memory_order_relaxed); }
+
+    // 文本消息（冷路径）：detail 被复制，超过一条记录时拆成连续的多条
+    void message(LogLevel level, LogCategory category, const char* format, std::string_view detail = {}) {
+        if (enabled(category, level)) writeMessage(level, category, format, detail);
+    }
+
+    // 事件记录（热路径）：事件、最多 LogRecord::kMaxActions 个动作编号和一段短文本（超长截断）。
+    // 动作编号在输出时按 ActionMap 的当前绑定表解析为动作名
+    void event(LogLevel level, LogCategory category, const char* format, const DeviceEvent& source,
+               const ActionId* actionIds = nullptr, size_t actionCount = 0, std::string_view note = {}) {
+        if (!enabled(category, level)) return;
+        LogRecord record;
+        fillHeader(record, level, category, LogRecord::Event, format);
+        record.actionCount = static_cast<uint8_t>(actionCount < LogRecord::kMaxActions ? actionCount
+                                                                                      : LogRecord::kMaxActions);
+        for (size_t i = 0; i < record.actionCount; ++i) record.actions[i] = actionIds[i];
+        record.event = source;
+        record.length = static_cast<uint8_t>(note.size() < LogRecord::kTextSize ? note.size()
+                                                                               : LogRecord::kTextSize);
+        note.copy(record.text, record.length);
+        submit(&record, 1);
+    }
+
+private:
+    InputLog();
+    ~InputLog();
+
+    // 每个写入线程独占的环（见 ThreadSlots）：线程写 tail，消费者（持有 drainMutex 的线程）写 head。
+    // 线程退出后环由新线程接手，未取出的记录仍会被输出
+    struct ThreadRing {
+        std::unique_ptr<LogRecord[]> slots{new LogRecord[kRingCapacity]};
+        alignas(64) std::atomic<size_t> tail{0};
+        size_t cachedHead = 0;
+        alignas(64) std::atomic<size_t> head{0};
+    };
+
+    static void fillHeader(LogRecord& record, LogLevel level, LogCategory category, LogRecord::Kind kind,
+                           const char* format);
+
+    void writeMessage(LogLevel level, LogCategory category, const char* format, std::string_view detail);
+
+    // 把 n 条记录一次性写入当前线程的环（整组要么全部写入，要么全部丢弃）
+    void submit(const LogRecord* records, size_t n);
+
+    void run(uint32_t intervalMillis);
+    // 取出所有环中的记录并输出（调用方持有 drainMutex）
+    void drainLocked();
+    void formatLocked(const LogRecord* records, size_t n);
+    void formatLocked(const LogRecord* records, size_t n, const BindingTable* bindings);
+    void writeLocked();
+
+    std::atomic<uint8_t> thresholds[kLogCategoryCount];
+    std::atomic<uint64_t> dropped{0};
+
+    ThreadSlots<ThreadRing> rings;
+
+    std::mutex drainMutex; // 同一时刻只有一个线程消费与输出
+    std::vector<ThreadRing*> ringList;
+    std::vector<LogRecord> batch;
+    std::string outText;
+    std::string errText;
+    std::ostream* out;
+    std::ostream* err;
+    uint64_t epoch; // 输出的时间以此为零点
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::atomic<bool> active{false}; // 后台线程在运行：写入进入环，否则直接输出
+    std::thread worker;
+};
+
+#endif // INPUT_LOG_H
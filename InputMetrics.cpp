@@ -0,0 +1,227 @@
+#include "InputMetrics.h"
+#include "nlohmann/json.hpp"
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using json = nlohmann::json;
+
+#ifdef INPUT_METRICS
+
+struct InputMetrics::Registry {
+    ThreadSlots<Shard> shards;
+
+    // reset() 时的合并值，snapshot() 从中减去
+    std::mutex baselineMutex;
+    MetricsSnapshot baseline;
+};
+
+InputMetrics::Registry& InputMetrics::registry() {
+    static Registry instance;
+    return instance;
+}
+
+InputMetrics::Shard& InputMetrics::acquireShard() {
+    return registry().shards.local();
+}
+
+#endif // INPUT_METRICS
+
+const char* metricCounterName(MetricCounter counter) {
+    switch (counter) {
+        case MetricCounter::EventsKeyboard:
+            return "events.keyboard";
+        case MetricCounter::EventsTouch:
+            return "events.touch";
+        case MetricCounter::FilteredTouchGate:
+            return "filtered.touch_gate";
+        case MetricCounter::FilteredDevicePriority:
+            return "filtered.device_priority";
+        case MetricCounter::FilteredLastInputWins:
+            return "filtered.last_input_wins";
+        case MetricCounter::FilteredCustom:
+            return "filtered.custom";
+        case MetricCounter::UnboundInputs:
+            return "inputs.unbound";
+        case MetricCounter::CommandsExecuted:
+            return "commands.executed";
+        case MetricCounter::CommandsQueued:
+            return "commands.queued";
+        case MetricCounter::CommandsDropped:
+            return "commands.dropped";
+        case MetricCounter::BindingReloads:
+            return "bindings.reloads";
+        case MetricCounter::BindingReloadFailures:
+            return "bindings.reload_failures";
+        default:
+            return "unknown";
+    }
+}
+
+const char* metricHistogramName(MetricHistogram histogram) {
+    switch (histogram) {
+        case MetricHistogram::PollNanos:
+            return "poll_ns";
+        case MetricHistogram::FrameNanos:
+            return "frame_ns";
+        case MetricHistogram::ActionLatencyNanos:
+            return "action_latency_ns";
+        case MetricHistogram::CommandQueueDepth:
+            return "command_queue_depth";
+        default:
+            return "unknown";
+    }
+}
+
+uint64_t HistogramSnapshot::percentile(double p) const {
+    if (count == 0) return 0;
+    if (p < 0.0) p = 0.0;
+    if (p > 100.0) p = 100.0;
+    // 第 rank 个（从 1 开始）样本所在的桶
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(count) + 0.5);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HistogramBuckets::kCount; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            const uint64_t upper = HistogramBuckets::upperBound(i);
+            return upper < max ? upper : max;
+        }
+    }
+    return max;
+}
+
+MetricsSnapshot InputMetrics::snapshot() {
+    MetricsSnapshot total;
+#ifdef INPUT_METRICS
+    Registry& all = registry();
+    uint64_t minSeen[kMetricHistogramCount];
+    for (uint64_t& m : minSeen) m = UINT64_MAX;
+    all.shards.forEach([&](const Shard& shard) {
+        for (size_t c = 0; c < kMetricCounterCount; ++c) {
+            total.counters[c] += shard.counters[c].load(std::memory_order_relaxed);
+        }
+        for (size_t h = 0; h < kMetricHistogramCount; ++h) {
+            const Histogram& source = shard.histograms[h];
+            HistogramSnapshot& target = total.histograms[h];
+            target.count += source.count.load(std::memory_order_relaxed);
+            target.sum += source.sum.load(std::memory_order_relaxed);
+            const uint64_t low = source.min.load(std::memory_order_relaxed);
+            const uint64_t high = source.max.load(std::memory_order_relaxed);
+            if (low < minSeen[h]) minSeen[h] = low;
+            if (high > target.max) target.max = high;
+            for (size_t b = 0; b < HistogramBuckets::kCount; ++b) {
+                target.buckets[b] += source.buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+    });
+
+    std::lock_guard<std::mutex> lock(all.baselineMutex);
+    const MetricsSnapshot& baseline = all.baseline;
+    for (size_t c = 0; c < kMetricCounterCount; ++c) {
+        total.counters[c] -= baseline.counters[c];
+    }
+    for (size_t h = 0; h < kMetricHistogramCount; ++h) {
+        HistogramSnapshot& target = total.histograms[h];
+        const HistogramSnapshot& base = baseline.histograms[h];
+        target.count -= base.count;
+        target.sum -= base.sum;
+        size_t first = HistogramBuckets::kCount;
+        size_t last = 0;
+        for (size_t b = 0; b < HistogramBuckets::kCount; ++b) {
+            target.buckets[b] -= base.buckets[b];
+            if (target.buckets[b]) {
+                if (first == HistogramBuckets::kCount) first = b;
+                last = b;
+            }
+        }
+        if (target.count == 0) {
+            target.min = target.max = 0;
+            continue;
+        }
+        // 分片只保存全程的最小/最大值；reset() 之后按桶的边界收紧
+        const uint64_t lower = HistogramBuckets::lowerBound(first);
+        const uint64_t upper = HistogramBuckets::upperBound(last);
+        target.min = minSeen[h] > lower ? minSeen[h] : lower;
+        if (upper < target.max) target.max = upper;
+    }
+#endif
+    return total;
+}
+
+void InputMetrics::reset() {
+#ifdef INPUT_METRICS
+    // 当前合并值加上旧零点即为全程值
+    Registry& all = registry();
+    MetricsSnapshot current = snapshot();
+    std::lock_guard<std::mutex> lock(all.baselineMutex);
+    for (size_t c = 0; c < kMetricCounterCount; ++c) {
+        all.baseline.counters[c] += current.counters[c];
+    }
+    for (size_t h = 0; h < kMetricHistogramCount; ++h) {
+        HistogramSnapshot& base = all.baseline.histograms[h];
+        const HistogramSnapshot& delta = current.histograms[h];
+        base.count += delta.count;
+        base.sum += delta.sum;
+        for (size_t b = 0; b < HistogramBuckets::kCount; ++b) base.buckets[b] += delta.buckets[b];
+    }
+#endif
+}
+
+std::string MetricsSnapshot::toJson() const {
+    json data;
+    data["enabled"] = InputMetrics::kEnabled;
+    json& counterJson = data["counters"];
+    counterJson = json::object();
+    for (size_t c = 0; c < kMetricCounterCount; ++c) {
+        counterJson[metricCounterName(static_cast<MetricCounter>(c))] = counters[c];
+    }
+    json& histogramJson = data["histograms"];
+    histogramJson = json::object();
+    for (size_t h = 0; h < kMetricHistogramCount; ++h) {
+        const HistogramSnapshot& histogram = histograms[h];
+        json entry;
+        entry["count"] = histogram.count;
+        entry["min"] = histogram.min;
+        entry["max"] = histogram.max;
+        entry["mean"] = histogram.mean();
+        entry["p50"] = histogram.percentile(50.0);
+        entry["p90"] = histogram.percentile(90.0);
+        entry["p99"] = histogram.percentile(99.0);
+        entry["p999"] = histogram.percentile(99.9);
+        // 非空桶：[下界, 上界, 数量]
+        json buckets = json::array();
+        for (size_t b = 0; b < HistogramBuckets::kCount; ++b) {
+            if (histogram.buckets[b]) {
+                buckets.push_back({HistogramBuckets::lowerBound(b), HistogramBuckets::upperBound(b),
+                                   histogram.buckets[b]});
+            }
+        }
+        entry["buckets"] = std::move(buckets);
+        histogramJson[metricHistogramName(static_cast<MetricHistogram>(h))] = std::move(entry);
+    }
+    return data.dump(2);
+}
+
+std::string MetricsSnapshot::toText() const {
+    std::string text;
+    char line[160];
+    for (size_t c = 0; c < kMetricCounterCount; ++c) {
+        std::snprintf(line, sizeof(line), "%-26s %llu\n", metricCounterName(static_cast<MetricCounter>(c)),
+                      static_cast<unsigned long long>(counters[c]));
+        text += line;
+    }
+    for (size_t h = 0; h < kMetricHistogramCount; ++h) {
+        const HistogramSnapshot& histogram = histograms[h];
+        std::snprintf(line, sizeof(line),
+                      "%-26s count=%llu mean=%.0f p50=%llu p99=%llu max=%llu\n",
+                      metricHistogramName(static_cast<MetricHistogram>(h)),
+                      static_cast<unsigned long long>(histogram.count), histogram.mean(),
+                      static_cast<unsigned long long>(histogram.percentile(50.0)),
+                      static_cast<unsigned long long>(histogram.percentile(99.0)),
+                      static_cast<unsigned long long>(histogram.max));
+        text += line;
+    }
+    return text;
+}
@@ -0,0 +1,178 @@
+#ifndef INPUT_METRICS_H
+#define INPUT_METRICS_H
+
+#include "DeviceEvent.h"
+#include "InputClock.h"
+#include "ThreadSlots.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 计数器
+enum class MetricCounter : uint8_t {
+    EventsKeyboard,        // DeviceManager::pollEvents 取出的事件（按设备）
+    EventsTouch,
+    FilteredTouchGate,     // 被各冲突规则过滤的事件
+    FilteredDevicePriority,
+    FilteredLastInputWins,
+    FilteredCustom,        // 被自定义策略过滤
+    UnboundInputs,         // 通过冲突检测但没有绑定任何动作的输入
+    CommandsExecuted,
+    CommandsQueued,        // Deferred 模式下写入命令队列
+    CommandsDropped,       // 命令队列满被丢弃
+    BindingReloads,        // ActionMap 发布新绑定表（加载、热重载、改键）
+    BindingReloadFailures
+};
+
+constexpr size_t kMetricCounterCount = 12;
+
+// 直方图
+enum class MetricHistogram : uint8_t {
+    PollNanos,          // DeviceManager::pollEvents 耗时
+    FrameNanos,         // InputProcessor 处理一帧事件的耗时
+    ActionLatencyNanos, // 采集 -> 命令执行（需开启 InputTrace）
+    CommandQueueDepth   // dispatchCommands 时命令队列中的命令数
+};
+
+constexpr size_t kMetricHistogramCount = 4;
+
+const char* metricCounterName(MetricCounter counter);
+const char* metricHistogramName(MetricHistogram histogram);
+
+inline MetricCounter eventsCounter(DeviceType device) {
+    static_assert(kDeviceTypeCount == 2, "add a per-device event counter for the new device type");
+    return static_cast<MetricCounter>(static_cast<size_t>(MetricCounter::EventsKeyboard) +
+                                      static_cast<size_t>(device));
+}
+
+// HDR 风格的对数-线性分桶：每个 2 的幂区间再分 8 个等宽子桶，相对误差不超过 12.5%，
+// 用固定的 496 个桶覆盖整个 uint64 范围
+struct HistogramBuckets {
+    static constexpr unsigned kSubBits = 3;
+    static constexpr size_t kSubCount = size_t(1) << kSubBits;
+    static constexpr size_t kCount = (64 - kSubBits + 1) * kSubCount;
+
+    static size_t index(uint64_t value) {
+        if (value < kSubCount) return static_cast<size_t>(value);
+        const unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(value));
+        const unsigned shift = msb - kSubBits;
+        return (static_cast<size_t>(shift + 1) << kSubBits) | static_cast<size_t>((value >> shift) & (kSubCount - 1));
+    }
+    static uint64_t lowerBound(size_t index) {
+        if (index < kSubCount) return index;
+        const unsigned shift = static_cast<unsigned>(index >> kSubBits) - 1;
+        return (static_cast<uint64_t>(kSubCount | (index & (kSubCount - 1)))) << shift;
+    }
+    // 桶内最大值
+    static uint64_t upperBound(size_t index) {
+        if (index + 1 >= kCount) return UINT64_MAX;
+        return lowerBound(index + 1) - 1;
+    }
+};
+
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    uint64_t buckets[HistogramBuckets::kCount] = {};
+
+    double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+    // 第 p 百分位（0~100）所在桶的上界，不超过观测到的最大值
+    uint64_t percentile(double p) const;
+};
+
+// 所有线程的计数合并后的结果
+struct MetricsSnapshot {
+    uint64_t counters[kMetricCounterCount] = {};
+    HistogramSnapshot histograms[kMetricHistogramCount];
+
+    uint64_t counter(MetricCounter c) const { return counters[static_cast<size_t>(c)]; }
+    const HistogramSnapshot& histogram(MetricHistogram h) const { return histograms[static_cast<size_t>(h)]; }
+
+    std::string toJson() const;
+    std::string toText() const;
+};
+
+// 流水线指标。每个线程写自己的分片（按缓存行对齐，单写者、无原子读改写），
+// 读取时合并所有分片，因此更新不会在线程间产生争用。
+// 以 -DINPUT_METRICS=OFF 构建时所有更新都是空的内联函数，snapshot() 返回全零。
+class InputMetrics {
+public:
+#ifdef INPUT_METRICS
+    static constexpr bool kEnabled = true;
+
+    static void add(MetricCounter counter, uint64_t n = 1) {
+        bump(shard().counters[static_cast<size_t>(counter)], n);
+    }
+    static void record(MetricHistogram histogram, uint64_t value) {
+        shard().histograms[static_cast<size_t>(histogram)].record(value);
+    }
+#else
+    static constexpr bool kEnabled = false;
+
+    static void add(MetricCounter, uint64_t = 1) {}
+    static void record(MetricHistogram, uint64_t) {}
+#endif
+
+    // 合并所有线程的分片（减去上一次 reset() 时的值）
+    static MetricsSnapshot snapshot();
+    // 以当前值为新的零点；不修改各线程的分片，可与更新并发调用
+    static void reset();
+
+private:
+#ifdef INPUT_METRICS
+    struct alignas(64) Histogram {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> min{UINT64_MAX};
+        std::atomic<uint64_t> max{0};
+        std::atomic<uint64_t> buckets[HistogramBuckets::kCount] = {};
+
+        void record(uint64_t value) {
+            bump(count, 1);
+            bump(sum, value);
+            if (value < min.load(std::memory_order_relaxed)) min.store(value, std::memory_order_relaxed);
+            if (value > max.load(std::memory_order_relaxed)) max.store(value, std::memory_order_relaxed);
+            bump(buckets[HistogramBuckets::index(value)], 1);
+        }
+    };
+
+    // 每个线程独占一个分片（见 ThreadSlots），线程退出后由新线程接手继续累加
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> counters[kMetricCounterCount] = {};
+        Histogram histograms[kMetricHistogramCount];
+    };
+
+    static void bump(std::atomic<uint64_t>& slot, uint64_t n) {
+        slot.store(slot.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static Shard& shard() {
+        Shard* current = ThreadSlots<Shard>::claimed();
+        return current ? *current : acquireShard();
+    }
+    static Shard& acquireShard();
+
+    struct Registry; // 所有分片与 reset() 的零点
+    static Registry& registry();
+#endif
+};
+
+// 作用域计时：析构时把经过的纳秒数记入直方图（指标关闭时为空）
+class MetricsTimer {
+public:
+#ifdef INPUT_METRICS
+    explicit MetricsTimer(MetricHistogram histogram) : target(histogram), start(inputNowNanos()) {}
+    ~MetricsTimer() { InputMetrics::record(target, inputNowNanos() - start); }
+
+private:
+    MetricHistogram target;
+    uint64_t start;
+#else
+    explicit MetricsTimer(MetricHistogram) {}
+#endif
+};
+
+#endif // INPUT_METRICS_H
@@ -2,46 +2,140 @@
 #define INPUT_PROCESSOR_H
 
 #include "ActionMap.h"
+#include "ActionState.h"
 #include "Command.h"
+#include "CommandBuffer.h"
+#include "CommandQueue.h"
 #include "ConflictResolver.h"
 #include "DeviceEvent.h"
+#include "InputMetrics.h"
+#include "InputTrace.h"
+#include <limits>
+#include <type_traits>
 #include <vector>
 #include <memory>
 
+// 命令的执行方式
+enum class DispatchMode {
+    Immediate, // 在调用 processInput 的线程上立即执行
+    Deferred   // 写入命令队列，由游戏线程调用 dispatchCommands() 执行
+};
+
+// 输入处理器在帧边界上的全部可回滚状态（POD，可整体拷贝）
+struct InputFrameState {
+    ActionFrame actions;      // 正在构建的帧（held、模拟量与帧号）
+    ConflictState conflict;   // 内置冲突规则的状态
+    ComboMatcherState combos; // 连招识别进度
+};
+
+static_assert(std::is_trivially_copyable<InputFrameState>::value, "InputFrameState must stay memcpy-able");
+
 // 输入处理器：从事件流和动作映射生成命令
 class InputProcessor {
 public:
-    InputProcessor(const ActionMap& map) : actionMap(map) {}
+    InputProcessor(const ActionMap& map, size_t commandCapacity = 1024)
+        : actionMap(map), commandArena(commandCapacity) {
+        commandHandlers.setDefaultHandler(&printActionCommand, &handlerBindings);
+    }
 
-    // 处理单个输入事件
-    void processInput(const DeviceEvent& event) {
-        // 首先检查是否应该处理这个输入事件
-        if (!conflictResolver.shouldProcessInput(event)) {
-            return;
+    // 切换执行方式（不能与 processInput / dispatchCommands 并发调用）。
+    // Deferred 模式下 processInput 只做冲突检测、动作状态与命令生成，
+    // 命令回调和延迟统计都在调用 dispatchCommands() 的线程上进行
+    void setDispatchMode(DispatchMode mode, size_t queueCapacity = 4096,
+                         BackpressurePolicy policy = BackpressurePolicy::DropNewest) {
+        if (mode == DispatchMode::Deferred && !commandQueue) {
+            commandQueue = std::make_unique<CommandQueue>(queueCapacity, policy);
         }
-        
-        // 生成命令
-        auto commands = generateCommandsForEvent(event);
-        
-        // 执行所有生成的命令
-        for (const auto& cmd : commands) {
-            cmd->execute();
+        dispatchMode = mode;
+    }
+    DispatchMode getDispatchMode() const { return dispatchMode; }
+
+    // 游戏线程在帧内固定位置调用：成批执行队列中的命令，返回执行的数量。
+    // 回调中按调用时的绑定表解析动作
+    size_t dispatchCommands(size_t maxBatch = std::numeric_limits<size_t>::max()) {
+        if (!commandQueue) return 0;
+        InputMetrics::record(MetricHistogram::CommandQueueDepth, commandQueue->sizeApprox());
+        BindingSnapshot bindings = actionMap.snapshot();
+        handlerBindings = &*bindings;
+        size_t count = commandQueue->drain(
+            [&](const ActionCommand& queued) {
+                ActionCommand command = queued;
+                InputTrace::mark(command.source, TraceStage::Execute);
+                commandHandlers.execute(command);
+                recordLatency(command);
+            },
+            maxBatch);
+        handlerBindings = nullptr;
+        InputMetrics::add(MetricCounter::CommandsExecuted, count);
+        return count;
+    }
+
+    // Deferred 模式的命令队列（未切换过时为空），用于读取背压统计
+    const CommandQueue* getCommandQueue() const { return commandQueue.get(); }
+
+    // 处理单个输入事件（动作状态在调用 endFrame() 时发布）
+    void processInput(const DeviceEvent& event) {
+        BindingSnapshot bindings = actionMap.snapshot();
+        frameBindings = &*bindings;
+        enqueueCommands(event);
+        flushCommands();
+        frameBindings = nullptr;
+    }
+
+    // 批量处理一帧的事件：先全部生成命令，再统一执行，最后发布本帧的动作状态。
+    // 整帧使用同一份绑定表快照，期间的热重载从下一帧开始生效
+    void processInput(const std::vector<DeviceEvent>& events) {
+        {
+            MetricsTimer timer(MetricHistogram::FrameNanos);
+            BindingSnapshot bindings = actionMap.snapshot();
+            frameBindings = &*bindings;
+            for (const DeviceEvent& event : events) {
+                enqueueCommands(event);
+            }
+            flushCommands();
+            frameBindings = nullptr;
         }
+        endFrame();
+    }
+
+    // 发布本帧的动作状态（逐个事件调用 processInput 时，每帧末尾调用一次）
+    void endFrame() { actionState.endFrame(); }
+
+    // 动作状态：游戏线程可随时读取最近发布的一帧
+    const ActionState& getActionState() const { return actionState; }
+
+    // 保存/恢复帧边界上的状态（只能在帧之间、处理输入的线程上调用）。
+    // 自定义冲突策略的内部状态不在其中，回滚后由策略自行负责
+    void saveState(InputFrameState& out) const {
+        out.actions = actionState.pending();
+        out.conflict = conflictResolver.getEngine().state();
+        comboMatcher.save(out.combos);
+    }
+    void restoreState(const InputFrameState& saved) {
+        actionState.restorePending(saved.actions);
+        conflictResolver.getEngine().restoreState(saved.conflict);
+        comboMatcher.restore(saved.combos);
     }
 
-    // 为单个事件生成命令
+    // 兼容接口：为单个事件生成堆上分配的命令对象（热路径请使用 processInput）
     std::vector<std::shared_ptr<ICommand>> generateCommandsForEvent(const DeviceEvent& event) {
+        BindingSnapshot bindings = actionMap.snapshot();
         std::vector<std::shared_ptr<ICommand>> commands;
-        auto actions = actionMap.getActions(event);
-        
-        for (const auto& action : actions) {
-            auto command = std::make_shared<GameActionCommand>(action, event);
+        for (ActionId id : bindings->lookup(event.device, event.code)) {
+            auto command = std::make_shared<GameActionCommand>(bindings->action(id), event);
             commands.push_back(command);
         }
-        
+
         return commands;
     }
 
+    // 命令回调表：游戏逻辑在此按动作注册回调
+    CommandHandlerTable& getCommandHandlers() { return commandHandlers; }
+
+    // 每个动作"采集 -> 执行"的延迟统计（需开启 InputTrace）
+    const ActionLatencyTracker& getLatencyTracker() const { return latencyTracker; }
+    void resetLatencyStats() { latencyTracker.reset(); }
+
     // 添加冲突解决策略
     void addConflictStrategy(std::shared_ptr<IConflictResolutionStrategy> strategy) {
         conflictResolver.addStrategy(strategy);
@@ -51,8 +145,81 @@ public:
     ConflictResolver& getConflictResolver() { return conflictResolver; }
 
 private:
+    // 冲突检测后把事件对应的命令写入命令池；池满时先执行已有命令
+    void enqueueCommands(const DeviceEvent& event) {
+        if (!conflictResolver.admit(event)) {
+            return;
+        }
+        DeviceEvent traced = event;
+        InputTrace::mark(traced, TraceStage::Resolve);
+        const bool press = isPressEvent(event);
+        const ActionIdSpan ids = frameBindings->lookup(event.device, event.code);
+        if (ids.empty()) {
+            InputMetrics::add(MetricCounter::UnboundInputs);
+            return;
+        }
+        for (ActionId id : ids) {
+            actionState.apply(id, event);
+            pushCommand(id, traced);
+            // 按下类动作送入连招识别，识别出的连招作为合成动作紧随其后执行
+            if (press) {
+                comboMatcher.feed(frameBindings->combos(), id, event.timestamp,
+                                  [&](ActionId combo, uint64_t timestamp) {
+                                      actionState.pulse(combo, timestamp);
+                                      pushCommand(combo, traced);
+                                  });
+            }
+        }
+    }
+
+    void pushCommand(ActionId id, const DeviceEvent& source) {
+        if (!commandArena.push(id, source)) {
+            flushCommands();
+            commandArena.push(id, source);
+        }
+    }
+
+    // 执行命令池中的所有命令（Deferred 模式下转交命令队列）并清空
+    void flushCommands() {
+        if (dispatchMode == DispatchMode::Deferred) {
+            uint64_t queued = 0;
+            for (const ActionCommand& command : commandArena) {
+                queued += commandQueue->push(command) ? 1 : 0;
+            }
+            InputMetrics::add(MetricCounter::CommandsQueued, queued);
+            InputMetrics::add(MetricCounter::CommandsDropped, commandArena.size() - queued);
+            commandArena.clear();
+            return;
+        }
+        handlerBindings = frameBindings;
+        for (ActionCommand& command : commandArena) {
+            InputTrace::mark(command.source, TraceStage::Execute);
+            commandHandlers.execute(command);
+            recordLatency(command);
+        }
+        handlerBindings = nullptr;
+        InputMetrics::add(MetricCounter::CommandsExecuted, commandArena.size());
+        commandArena.clear();
+    }
+
+    void recordLatency(const ActionCommand& command) {
+        latencyTracker.record(command.action, command.source);
+        if (command.source.trace.execute != 0) {
+            InputMetrics::record(MetricHistogram::ActionLatencyNanos, command.source.trace.execute);
+        }
+    }
+
     const ActionMap& actionMap;
+    const BindingTable* frameBindings = nullptr; // 当前帧的绑定表快照，仅在 processInput 内有效
+    const BindingTable* handlerBindings = nullptr; // 执行命令回调时使用的绑定表（默认回调的 context）
     ConflictResolver conflictResolver;
+    ComboMatcher comboMatcher;
+    ActionState actionState;
+    CommandArena commandArena;
+    CommandHandlerTable commandHandlers;
+    ActionLatencyTracker latencyTracker;
+    DispatchMode dispatchMode = DispatchMode::Immediate;
+    std::unique_ptr<CommandQueue> commandQueue;
 };
 
-#endif // INPUT_PROCESSOR_H
\ No newline at end of file
+#endif // INPUT_PROCESSOR_H
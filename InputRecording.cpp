@@ -0,0 +1,78 @@
+#include "InputRecording.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+using namespace InputRecording;
+
+bool InputRecorder::open(const std::string& path) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Could not open recording file: " << path << std::endl;
+        return false;
+    }
+    buffer.resize(1 << 16);
+    std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+
+    header = Header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.recordSize = sizeof(Record);
+    lastTimestamp = 0;
+    // 先写入占位头，close() 时回填
+    std::fwrite(&header, sizeof(header), 1, file);
+    return true;
+}
+
+void InputRecorder::writeRecord(const Record& record) {
+    std::fwrite(&record, sizeof(record), 1, file);
+    ++header.recordCount;
+}
+
+void InputRecorder::record(const DeviceEvent& event) {
+    if (!file) return;
+
+    if (header.recordCount == 0) {
+        header.baseTimestamp = event.timestamp;
+        lastTimestamp = event.timestamp;
+    }
+    uint64_t delta = event.timestamp > lastTimestamp ? event.timestamp - lastTimestamp : 0;
+    lastTimestamp = std::max(lastTimestamp, event.timestamp);
+
+    Record record{};
+    if (delta > std::numeric_limits<uint32_t>::max()) {
+        Record extension{};
+        extension.device = kRecordTimeExtension;
+        extension.code = static_cast<int32_t>(static_cast<uint32_t>(delta >> 32));
+        uint32_t low = static_cast<uint32_t>(delta);
+        std::memcpy(&extension.value, &low, sizeof(low));
+        writeRecord(extension);
+        delta = 0;
+    }
+    if (event.instanceId != 0 || event.x != 0.0f || event.y != 0.0f) {
+        Record extension{};
+        extension.device = kRecordInstanceAxes;
+        extension.pointer = event.instanceId;
+        std::memcpy(&extension.code, &event.x, sizeof(event.x));
+        extension.value = event.y;
+        writeRecord(extension);
+    }
+    record.deltaNanos = static_cast<uint32_t>(delta);
+    record.device = static_cast<uint8_t>(event.device);
+    record.type = static_cast<uint8_t>(event.type);
+    record.pointer = event.pointerId;
+    record.code = event.code;
+    record.value = event.value;
+    writeRecord(record);
+}
+
+void InputRecorder::close() {
+    if (!file) return;
+    std::fflush(file);
+    std::fseek(file, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fclose(file);
+    file = nullptr;
+}
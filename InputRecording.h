@@ -0,0 +1,84 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include "DeviceEvent.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// 输入录制文件格式（小端）：
+//   RecordingHeader（32 字节）+ 若干定长 16 字节记录。
+//   每条记录保存相对上一条记录的时间增量（纳秒）。增量超过 uint32 时，
+//   先写入一条时间扩展记录（device == kRecordTimeExtension），其 code/value 字段
+//   合起来保存完整的 64 位增量，后面的事件记录增量为 0。
+//   实例编号或 x/y 不为 0 的事件之前有一条实例扩展记录（device == kRecordInstanceAxes，
+//   增量为 0），其 pointer 字段保存实例编号，code/value 字段按位保存 x/y。
+//   版本 2 只为触摸事件写位置扩展记录（device == kRecordTouchPosition，code/value 为 x/y），
+//   版本 1 没有触点编号与位置；读取时缺少的字段视为 0。
+namespace InputRecording {
+
+constexpr char kMagic[4] = {'K', 'S', 'I', 'R'};
+constexpr uint16_t kVersion = 3;
+constexpr uint16_t kMinVersion = 1;
+constexpr uint8_t kRecordTimeExtension = 0xFF;
+constexpr uint8_t kRecordTouchPosition = 0xFE; // 只出现在版本 2 中
+constexpr uint8_t kRecordInstanceAxes = 0xFD;
+
+struct Header {
+    char magic[4];
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t baseTimestamp; // 第一条事件的时间戳
+    uint64_t recordCount;   // 记录条数（含时间扩展记录）
+};
+static_assert(sizeof(Header) == 32, "recording header must stay 32 bytes");
+
+struct Record {
+    uint32_t deltaNanos;
+    uint8_t device;
+    uint8_t type;
+    uint16_t pointer; // 触点编号（版本 1 中为 0）
+    int32_t code;
+    float value;
+};
+static_assert(sizeof(Record) == 16, "recording record must stay 16 bytes");
+
+} // namespace InputRecording
+
+// 把原始 DeviceEvent 流写入二进制录制文件
+class InputRecorder {
+public:
+    InputRecorder() = default;
+    ~InputRecorder() { close(); }
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    bool open(const std::string& path);
+    bool isOpen() const { return file != nullptr; }
+
+    // 追加一条事件；时间戳应单调不减（例如 DeviceManager::pollEvents 的输出）
+    void record(const DeviceEvent& event);
+    void record(const std::vector<DeviceEvent>& events) {
+        for (const DeviceEvent& event : events) record(event);
+    }
+
+    // 回填文件头中的记录数并关闭文件
+    void close();
+
+    uint64_t recordCount() const { return header.recordCount; }
+
+private:
+    void writeRecord(const InputRecording::Record& record);
+
+    std::FILE* file = nullptr;
+    std::vector<char> buffer;
+    InputRecording::Header header{};
+    uint64_t lastTimestamp = 0;
+};
+
+#endif // INPUT_RECORDING_H
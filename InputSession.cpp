@@ -0,0 +1,55 @@
+#include "InputSession.h"
+#include "EventMerge.h"
+
+InputSession::InputSession(uint32_t id, std::shared_ptr<const BindingTable> table,
+                           size_t queueCapacity, size_t commandCapacity)
+    : sessionId(id),
+      events(queueCapacity),
+      bindings(table ? std::move(table) : std::make_shared<const BindingTable>()),
+      commandArena(commandCapacity) {
+    frame.reserve(events.capacity());
+}
+
+size_t InputSession::tick() {
+    MetricsTimer timer(MetricHistogram::FrameNanos);
+    frame.clear();
+    if (source && source->isEnabled()) {
+        VectorEventSink sink(frame);
+        source->pollInto(sink);
+    }
+    events.drain([&](const DeviceEvent& event) { frame.push_back(event); });
+    // 事件源与投递的事件各自有序，合并后按时间戳排序
+    sortEventRun(frame.data(), frame.data() + frame.size());
+
+    RcuReadGuard guard;
+    const BindingTable* table = bindings.get();
+    for (const DeviceEvent& event : frame) {
+        if (!conflictResolver.admit(event)) {
+            continue;
+        }
+        const bool press = isPressEvent(event);
+        const ActionIdSpan ids = table->lookup(event.device, event.code);
+        if (ids.empty()) {
+            InputMetrics::add(MetricCounter::UnboundInputs);
+            continue;
+        }
+        for (ActionId id : ids) {
+            pushCommand(id, event);
+            if (press) {
+                comboMatcher.feed(table->combos(), id, event.timestamp,
+                                  [&](ActionId combo, uint64_t) { pushCommand(combo, event); });
+            }
+        }
+    }
+    commandArena.flush(commandHandlers);
+
+    processed += frame.size();
+    return frame.size();
+}
+
+void InputSession::pushCommand(ActionId id, const DeviceEvent& source) {
+    if (!commandArena.push(id, source)) {
+        commandArena.flush(commandHandlers);
+        commandArena.push(id, source);
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef INPUT_SESSION_H
+#define INPUT_SESSION_H
+
+#include "BindingTable.h"
+#include "CommandBuffer.h"
+#include "ConflictResolver.h"
+#include "DeviceEvent.h"
+#include "EventRing.h"
+#include "IDeviceAdapter.h"
+#include "Rcu.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 一个玩家的输入会话（服务端/云游戏场景，每个连接一个）。
+// 会话自己拥有事件流、冲突与连招状态和命令池，不依赖任何单例；绑定表是不可变的，
+// 多个会话共享同一份（例如 ActionMap::shareBindings() 的结果）。
+class InputSession {
+public:
+    InputSession(uint32_t id, std::shared_ptr<const BindingTable> bindings,
+                 size_t queueCapacity = 1024, size_t commandCapacity = 256);
+
+    InputSession(const InputSession&) = delete;
+    InputSession& operator=(const InputSession&) = delete;
+
+    uint32_t id() const { return sessionId; }
+
+    // 投递事件（无锁，可在网络线程调用）
+    bool submit(const DeviceEvent& event) { return events.push(event); }
+
+    // 会话的事件源（例如该玩家的网络适配器），每次 tick 时在工作线程上轮询。
+    // 不能与 tick 并发调用（SessionEngine 在会话创建后、tick 之外设置）
+    void setSource(std::shared_ptr<IDeviceAdapter> adapter) { source = std::move(adapter); }
+
+    // 切换该会话使用的绑定表（可在任意线程调用），从下一次 tick 开始生效
+    void setBindings(std::shared_ptr<const BindingTable> table) {
+        if (table) bindings.publish(std::move(table));
+    }
+    std::shared_ptr<const BindingTable> shareBindings() const { return bindings.share(); }
+
+    ConflictResolver& getConflictResolver() { return conflictResolver; }
+    CommandHandlerTable& getCommandHandlers() { return commandHandlers; }
+
+    // 处理已积累的事件并执行命令，返回处理的事件数。
+    // 同一会话同一时刻只能有一个线程调用
+    size_t tick();
+
+    uint64_t processedEvents() const { return processed; }
+    uint64_t droppedEvents() const { return events.droppedCount(); }
+
+private:
+    void pushCommand(ActionId id, const DeviceEvent& source);
+
+    uint32_t sessionId;
+    EventRing events;
+    RcuCell<BindingTable> bindings;
+    std::shared_ptr<IDeviceAdapter> source;
+    ConflictResolver conflictResolver;
+    ComboMatcher comboMatcher;
+    CommandArena commandArena;
+    CommandHandlerTable commandHandlers;
+    std::vector<DeviceEvent> frame; // tick 内复用
+    uint64_t processed = 0;
+};
+
+#endif // INPUT_SESSION_H
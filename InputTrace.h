@@ -0,0 +1,87 @@
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include "BindingTable.h" // 用于 ActionId
+#include "DeviceEvent.h"
+#include "InputClock.h"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// 流水线中的追踪点（采集时刻即 DeviceEvent::timestamp）
+enum class TraceStage {
+    Enqueue,
+    Dequeue,
+    Resolve,
+    Execute
+};
+
+// 输入延迟追踪开关与打点。关闭时每个追踪点只有一次原子读
+class InputTrace {
+public:
+    static void setEnabled(bool on) { flag().store(on, std::memory_order_relaxed); }
+    static bool isEnabled() { return flag().load(std::memory_order_relaxed); }
+
+    // 在事件上记录当前阶段相对采集时刻的偏移
+    static void mark(DeviceEvent& event, TraceStage stage) {
+        if (!isEnabled()) return;
+        uint64_t now = inputNowNanos();
+        uint64_t delta = now > event.timestamp ? now - event.timestamp : 0;
+        uint32_t stamp = delta >= std::numeric_limits<uint32_t>::max()
+                             ? std::numeric_limits<uint32_t>::max()
+                             : static_cast<uint32_t>(delta == 0 ? 1 : delta);
+        switch (stage) {
+            case TraceStage::Enqueue: event.trace.enqueue = stamp; break;
+            case TraceStage::Dequeue: event.trace.dequeue = stamp; break;
+            case TraceStage::Resolve: event.trace.resolve = stamp; break;
+            case TraceStage::Execute: event.trace.execute = stamp; break;
+        }
+    }
+
+private:
+    static std::atomic<bool>& flag() {
+        static std::atomic<bool> enabled{false};
+        return enabled;
+    }
+};
+
+// 按动作统计"采集 -> 执行"的延迟
+class ActionLatencyTracker {
+public:
+    struct Stats {
+        uint64_t count = 0;
+        uint64_t totalNanos = 0;
+        uint64_t minNanos = std::numeric_limits<uint64_t>::max();
+        uint64_t maxNanos = 0;
+
+        double averageNanos() const { return count ? static_cast<double>(totalNanos) / count : 0.0; }
+    };
+
+    // 记录一次命令执行；事件没有执行时间点（未开启追踪）时忽略
+    void record(ActionId action, const DeviceEvent& event) {
+        if (event.trace.execute == 0) return;
+        if (action >= perAction.size()) perAction.resize(static_cast<size_t>(action) + 1);
+        Stats& s = perAction[action];
+        uint64_t latency = event.trace.execute;
+        ++s.count;
+        s.totalNanos += latency;
+        if (latency < s.minNanos) s.minNanos = latency;
+        if (latency > s.maxNanos) s.maxNanos = latency;
+    }
+
+    // 遍历有记录的动作：fn(ActionId, const Stats&)
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (size_t i = 0; i < perAction.size(); ++i) {
+            if (perAction[i].count) fn(static_cast<ActionId>(i), perAction[i]);
+        }
+    }
+
+    void reset() { perAction.clear(); }
+
+private:
+    std::vector<Stats> perAction;
+};
+
+#endif // INPUT_TRACE_H
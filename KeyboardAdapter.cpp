@@ -1,29 +1,20 @@
 #include "KeyboardAdapter.h"
-#include <chrono>
-#include <random>
+#include "InputClock.h"
 
 // 示例实现：无真输入，仅模拟空事件
-std::vector<DeviceEvent> KeyboardAdapter::pollEvents() {
-    std::vector<DeviceEvent> events;
-    if (!enabled) return events;
+void KeyboardAdapter::pollInto(EventSink& sink) {
+    if (!enabled) return;
     
-    static uint64_t lastEventTime = 0;
-    static bool isMoving = false;
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(500, 2000); // 随机间隔500-2000ms
-    
-    uint64_t currentTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
-    ).count();
+    uint64_t currentTime = inputNowNanos();
     
     // 模拟玩家操作模式：跳跃、移动、攻击
-    if (currentTime - lastEventTime >= dis(gen)) {
+    if (currentTime - lastEventTime >= dis(gen) * kNanosPerMilli) {
         // 随机选择一个动作
         int action = dis(gen) % 4; // 0:Jump, 1:Attack, 2:MoveForward, 3:MoveBackward
         
-        DeviceEvent event;
+        DeviceEvent event{};
         event.device = DeviceType::Keyboard;
+        event.instanceId = static_cast<uint16_t>(instanceId());
         event.timestamp = currentTime;
         
         switch (action) {
@@ -47,9 +38,7 @@ std::vector<DeviceEvent> KeyboardAdapter::pollEvents() {
                 break;
         }
         
-        events.push_back(event);
+        sink.push(event);
         lastEventTime = currentTime;
     }
-    
-    return events;
 }
\ No newline at end of file
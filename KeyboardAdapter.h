@@ -2,11 +2,22 @@
 #define KEYBOARD_ADAPTER_H
 
 #include "IDeviceAdapter.h"
+#include <cstdint>
+#include <random>
 
-// 键盘适配器（示例，实际接底层API）
+// 键盘适配器（示例，实际接底层API）。模拟状态按实例保存，指定 seed 时输出可复现
 class KeyboardAdapter : public IDeviceAdapter {
 public:
-    std::vector<DeviceEvent> pollEvents() override;
+    explicit KeyboardAdapter(uint32_t instanceId = 0, uint32_t seed = std::random_device{}())
+        : IDeviceAdapter(DeviceType::Keyboard, instanceId), gen(seed) {}
+
+    void pollInto(EventSink& sink) override;
+
+private:
+    uint64_t lastEventTime = 0;
+    bool isMoving = false;
+    std::mt19937 gen;
+    std::uniform_int_distribution<> dis{500, 2000}; // 随机间隔500-2000ms
 };
 
 #endif // KEYBOARD_ADAPTER_H
\ No newline at end of file
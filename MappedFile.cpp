@@ -0,0 +1,50 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define INPUT_HAS_MMAP 1
+#endif
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef INPUT_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                bytes = static_cast<const unsigned char*>(p);
+                length = static_cast<size_t>(st.st_size);
+                mapped = true;
+                ::madvise(p, length, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+        if (mapped) return true;
+    }
+#endif
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    fallback.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    bytes = fallback.data();
+    length = fallback.size();
+    return length > 0;
+}
+
+void MappedFile::close() {
+#ifdef INPUT_HAS_MMAP
+    if (mapped) {
+        ::munmap(const_cast<unsigned char*>(bytes), length);
+    }
+#endif
+    mapped = false;
+    bytes = nullptr;
+    length = 0;
+    fallback.clear();
+}
@@ -0,0 +1,215 @@
+#ifndef RCU_H
+#define RCU_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 基于纪元（epoch）的读-拷贝-更新（RCU）。
+//
+// 读者进入临界区时把当前全局纪元写入自己线程的槽位，离开时清零；读侧只有
+// 两次原子写，从不加锁、从不等待。写者发布新版本后推进全局纪元，旧版本只有
+// 在所有活跃读者的纪元都不早于发布时的纪元后才会被回收。
+class RcuDomain {
+public:
+    static constexpr size_t kMaxReaderThreads = 256;
+
+    static RcuDomain& instance() {
+        static RcuDomain domain;
+        return domain;
+    }
+
+    // 进入/离开读侧临界区，可嵌套
+    void readLock() {
+        ThreadState& state = threadState();
+        if (state.nesting++ == 0) {
+            ReaderSlot& slot = slots[state.slotIndex(*this)];
+            slot.epoch.store(globalEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        }
+    }
+
+    void readUnlock() {
+        ThreadState& state = threadState();
+        if (--state.nesting == 0) {
+            slots[state.slot].epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    // 写者：推进纪元，返回新纪元。在此之后进入的读者一定能看到已发布的新版本
+    uint64_t advance() { return globalEpoch.fetch_add(1, std::memory_order_seq_cst) + 1; }
+
+    // 调用线程是否处于读侧临界区
+    bool inReadSection() { return threadState().nesting != 0; }
+
+    // 调用线程是否正处于早于 epoch 开始的读侧临界区。若是，等待 epoch 的宽限期
+    // 结束必然死锁（要等的正是自己），写者据此把死锁变成异常
+    bool currentThreadBlocks(uint64_t epoch) {
+        ThreadState& state = threadState();
+        if (state.nesting == 0) return false;
+        uint64_t e = slots[state.slot].epoch.load(std::memory_order_relaxed);
+        return e != 0 && e < epoch;
+    }
+
+    // 是否所有读者都已越过 epoch（即不可能再持有该纪元之前发布的旧版本）
+    bool quiescentSince(uint64_t epoch) const {
+        for (const ReaderSlot& slot : slots) {
+            uint64_t e = slot.epoch.load(std::memory_order_seq_cst);
+            if (e != 0 && e < epoch) return false;
+        }
+        return true;
+    }
+
+private:
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<bool> used{false};
+    };
+
+    // 每个线程在首次读取时占用一个槽位，线程退出时归还
+    struct ThreadState {
+        RcuDomain* owner = nullptr;
+        size_t slot = 0;
+        int nesting = 0;
+
+        size_t slotIndex(RcuDomain& domain) {
+            if (!owner) {
+                slot = domain.acquireSlot();
+                owner = &domain;
+            }
+            return slot;
+        }
+
+        ~ThreadState() {
+            if (owner) owner->slots[slot].used.store(false, std::memory_order_release);
+        }
+    };
+
+    static ThreadState& threadState() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    size_t acquireSlot() {
+        for (size_t i = 0; i < kMaxReaderThreads; ++i) {
+            bool expected = false;
+            if (slots[i].used.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                return i;
+            }
+        }
+        throw std::runtime_error("RcuDomain: too many reader threads");
+    }
+
+    RcuDomain() = default;
+
+    ReaderSlot slots[kMaxReaderThreads];
+    std::atomic<uint64_t> globalEpoch{1};
+};
+
+// 读侧 RAII 守卫
+class RcuReadGuard {
+public:
+    RcuReadGuard() { RcuDomain::instance().readLock(); }
+    ~RcuReadGuard() { RcuDomain::instance().readUnlock(); }
+    RcuReadGuard(const RcuReadGuard&) = delete;
+    RcuReadGuard& operator=(const RcuReadGuard&) = delete;
+};
+
+// 用 RCU 发布的不可变对象。读者在守卫内通过 get() 拿到当前版本的指针；
+// 需要跨越守卫长期持有时用 share() 取得 shared_ptr。
+template <typename T>
+class RcuCell {
+public:
+    // 先构造 RcuDomain，保证它比任何（包括静态的）RcuCell 活得更久
+    explicit RcuCell(std::shared_ptr<const T> initial)
+        : current((RcuDomain::instance(), new Node{std::move(initial)})) {}
+
+    ~RcuCell() {
+        delete current.load(std::memory_order_relaxed);
+        for (auto& retired : retiredNodes) delete retired.node;
+    }
+
+    RcuCell(const RcuCell&) = delete;
+    RcuCell& operator=(const RcuCell&) = delete;
+
+    // 读者：必须在 RcuReadGuard 作用域内调用，返回的指针在守卫结束前有效
+    const T* get() const { return current.load(std::memory_order_seq_cst)->value.get(); }
+
+    // 读者：取得当前版本的共享所有权（一次原子引用计数递增，不加锁）
+    std::shared_ptr<const T> share() const {
+        RcuReadGuard guard;
+        return current.load(std::memory_order_seq_cst)->value;
+    }
+
+    // 写者：发布新版本。旧版本在宽限期结束后回收，读者不会被阻塞
+    void publish(std::shared_ptr<const T> next) {
+        Node* fresh = new Node{std::move(next)};
+        std::lock_guard<std::mutex> lk(writerMtx);
+        Node* old = current.exchange(fresh, std::memory_order_seq_cst);
+        uint64_t epoch = RcuDomain::instance().advance();
+        retiredNodes.push_back(Retired{old, epoch});
+        reclaimLocked();
+    }
+
+    // 写者：尝试回收已过宽限期的旧版本
+    void reclaim() {
+        std::lock_guard<std::mutex> lk(writerMtx);
+        reclaimLocked();
+    }
+
+    // 写者：等待宽限期结束并回收所有旧版本。调用线程不能处于读侧临界区
+    // （任何 RcuReadGuard，包括 BindingSnapshot、ActionStateView 等），
+    // 否则会等待自己而死锁；检测到这种情况时抛出 std::logic_error
+    void synchronize() {
+        std::lock_guard<std::mutex> lk(writerMtx);
+        reclaimLocked();
+        RcuDomain& domain = RcuDomain::instance();
+        for (const Retired& retired : retiredNodes) {
+            if (domain.currentThreadBlocks(retired.epoch)) {
+                throw std::logic_error("RcuCell::synchronize called inside a read-side critical section");
+            }
+        }
+        while (!retiredNodes.empty()) {
+            std::this_thread::yield();
+            reclaimLocked();
+        }
+    }
+
+    size_t pendingReclaim() const {
+        std::lock_guard<std::mutex> lk(writerMtx);
+        return retiredNodes.size();
+    }
+
+private:
+    struct Node {
+        std::shared_ptr<const T> value;
+    };
+    struct Retired {
+        Node* node;
+        uint64_t epoch;
+    };
+
+    void reclaimLocked() {
+        RcuDomain& domain = RcuDomain::instance();
+        size_t kept = 0;
+        for (Retired& retired : retiredNodes) {
+            if (domain.quiescentSince(retired.epoch)) {
+                delete retired.node;
+            } else {
+                retiredNodes[kept++] = retired;
+            }
+        }
+        retiredNodes.resize(kept);
+    }
+
+    std::atomic<Node*> current;
+    mutable std::mutex writerMtx;
+    std::vector<Retired> retiredNodes;
+};
+
+#endif // RCU_H
@@ -0,0 +1,107 @@
+#include "ReplayAdapter.h"
+#include "InputClock.h"
+#include <cstring>
+#include <iostream>
+
+using namespace InputRecording;
+
+bool ReplayAdapter::open(const std::string& path) {
+    records = nullptr;
+    recordCount = 0;
+    if (!file.open(path)) {
+        std::cerr << "Error: Could not open replay file: " << path << std::endl;
+        return false;
+    }
+    Header header{};
+    if (file.size() < sizeof(header)) {
+        std::cerr << "Error: Replay file too small: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version < kMinVersion || header.version > kVersion ||
+        header.recordSize != sizeof(Record)) {
+        std::cerr << "Error: Unsupported replay file format: " << path << std::endl;
+        return false;
+    }
+    // 文件被截断或录制未正常结束（记录数未回填）时，回放所有完整的记录
+    const uint64_t available = (file.size() - sizeof(header)) / sizeof(Record);
+    recordCount = header.recordCount && header.recordCount < available ? header.recordCount : available;
+    records = reinterpret_cast<const Record*>(file.data() + sizeof(header));
+    rewind();
+    return true;
+}
+
+void ReplayAdapter::rewind() {
+    cursor = 0;
+    recordedOffset = 0;
+    skipped = 0;
+    pendingInstance = 0;
+    pendingX = 0.0f;
+    pendingY = 0.0f;
+    replayStart = inputNowNanos();
+}
+
+void ReplayAdapter::pollInto(EventSink& sink) {
+    if (!enabled || recordCount == 0) return;
+
+    const double scale = speedMode == ReplaySpeed::Scaled ? speedScale : 1.0;
+    // 当前时刻对应的录制时间；最快模式下不受时间限制
+    const uint64_t now = inputNowNanos();
+    const uint64_t playhead = static_cast<uint64_t>((now - replayStart) * scale);
+
+    size_t emitted = 0;
+    while (emitted < batchSize) {
+        if (cursor >= recordCount) {
+            if (!looping) return;
+            // 循环回放：从下一帧开始重新计时
+            rewind();
+            return;
+        }
+        const Record& record = records[cursor];
+        uint64_t offset = recordedOffset + record.deltaNanos;
+        if (record.device == kRecordTimeExtension) {
+            uint32_t low = 0;
+            std::memcpy(&low, &record.value, sizeof(low));
+            offset = recordedOffset + ((static_cast<uint64_t>(static_cast<uint32_t>(record.code)) << 32) | low);
+        }
+        if (speedMode != ReplaySpeed::AsFastAsPossible && offset > playhead) {
+            return;
+        }
+        recordedOffset = offset;
+        ++cursor;
+        if (record.device == kRecordTimeExtension) {
+            continue;
+        }
+        if (record.device == kRecordInstanceAxes || record.device == kRecordTouchPosition) {
+            // 实例编号与 x/y 属于紧随其后的事件（版本 2 的位置记录没有实例编号）
+            pendingInstance = record.device == kRecordInstanceAxes ? record.pointer : 0;
+            std::memcpy(&pendingX, &record.code, sizeof(pendingX));
+            pendingY = record.value;
+            continue;
+        }
+        if (record.device >= kDeviceTypeCount || record.type >= kEventTypeCount) {
+            // 损坏或手工编辑过的记录：跳过，避免按设备/事件类型索引的数组越界
+            ++skipped;
+            pendingInstance = 0;
+            pendingX = 0.0f;
+            pendingY = 0.0f;
+            continue;
+        }
+
+        DeviceEvent event{};
+        event.device = static_cast<DeviceType>(record.device);
+        event.type = static_cast<EventType>(record.type);
+        event.instanceId = pendingInstance;
+        event.code = record.code;
+        event.value = record.value;
+        event.pointerId = record.pointer;
+        event.x = pendingX;
+        event.y = pendingY;
+        pendingInstance = 0;
+        pendingX = 0.0f;
+        pendingY = 0.0f;
+        event.timestamp = replayStart + static_cast<uint64_t>(offset / scale);
+        sink.push(event);
+        ++emitted;
+    }
+}
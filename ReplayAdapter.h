@@ -0,0 +1,61 @@
+#ifndef REPLAY_ADAPTER_H
+#define REPLAY_ADAPTER_H
+
+#include "IDeviceAdapter.h"
+#include "InputRecording.h"
+#include <cstdint>
+#include <string>
+
+// 回放速度模式
+enum class ReplaySpeed {
+    Original,        // 按录制时的节奏
+    Scaled,          // 按 speedScale 倍速
+    AsFastAsPossible // 每次轮询尽量多地输出（最多 batchSize 条）
+};
+
+// 回放适配器：mmap 录制文件，按原始节奏、倍速或最快速度重放事件。
+// 输出事件的时间戳以回放开始时刻为基准，保持录制时的相对间隔（按倍速缩放）。
+class ReplayAdapter : public IDeviceAdapter {
+public:
+    ReplayAdapter() = default;
+
+    // 打开录制文件；文件头校验失败返回 false
+    bool open(const std::string& path);
+
+    void setSpeed(ReplaySpeed mode, double scale = 1.0) {
+        speedMode = mode;
+        speedScale = scale > 0.0 ? scale : 1.0;
+    }
+    void setBatchSize(size_t size) { batchSize = size ? size : 1; }
+    void setLooping(bool on) { looping = on; }
+
+    // 重新从头开始回放
+    void rewind();
+
+    bool finished() const { return cursor >= recordCount && !looping; }
+    uint64_t totalRecords() const { return recordCount; }
+    // 本轮回放中因设备或事件类型越界而被跳过的记录数
+    uint64_t skippedRecords() const { return skipped; }
+
+    void pollInto(EventSink& sink) override;
+
+private:
+    MappedFile file;
+    const InputRecording::Record* records = nullptr;
+    uint64_t recordCount = 0;
+
+    ReplaySpeed speedMode = ReplaySpeed::Original;
+    double speedScale = 1.0;
+    size_t batchSize = 4096;
+    bool looping = false;
+
+    uint64_t cursor = 0;
+    uint64_t recordedOffset = 0;  // 当前游标处相对第一条事件的录制时间
+    uint64_t skipped = 0;
+    uint64_t replayStart = 0;     // 回放开始时的单调时钟
+    uint16_t pendingInstance = 0; // 扩展记录中的实例编号与 x/y，用于下一条事件
+    float pendingX = 0.0f;
+    float pendingY = 0.0f;
+};
+
+#endif // REPLAY_ADAPTER_H
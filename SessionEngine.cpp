@@ -0,0 +1,139 @@
+#include "SessionEngine.h"
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+SessionEngine::SessionEngine(size_t workerCount, bool pinWorkers) {
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    shards.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        shards.push_back(std::make_unique<Shard>());
+    }
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&SessionEngine::workerLoop, this, i, pinWorkers);
+    }
+}
+
+SessionEngine::~SessionEngine() {
+    {
+        std::lock_guard<std::mutex> lk(tickMtx);
+        stopping = true;
+    }
+    tickCv.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+std::shared_ptr<InputSession> SessionEngine::createSession(std::shared_ptr<const BindingTable> bindings,
+                                                           size_t queueCapacity) {
+    std::lock_guard<std::mutex> lk(sessionsMtx);
+    auto session = std::make_shared<InputSession>(nextSessionId++, std::move(bindings), queueCapacity);
+    auto emptiest = std::min_element(shards.begin(), shards.end(), [](const auto& a, const auto& b) {
+        return a->sessions.size() < b->sessions.size();
+    });
+    (*emptiest)->sessions.push_back(session);
+    return session;
+}
+
+bool SessionEngine::destroySession(uint32_t id) {
+    std::lock_guard<std::mutex> lk(sessionsMtx);
+    for (auto& shard : shards) {
+        auto& sessions = shard->sessions;
+        auto it = std::find_if(sessions.begin(), sessions.end(),
+                               [id](const auto& session) { return session->id() == id; });
+        if (it != sessions.end()) {
+            *it = std::move(sessions.back());
+            sessions.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<InputSession> SessionEngine::findSession(uint32_t id) const {
+    std::lock_guard<std::mutex> lk(sessionsMtx);
+    for (const auto& shard : shards) {
+        for (const auto& session : shard->sessions) {
+            if (session->id() == id) return session;
+        }
+    }
+    return nullptr;
+}
+
+size_t SessionEngine::sessionCount() const {
+    std::lock_guard<std::mutex> lk(sessionsMtx);
+    size_t count = 0;
+    for (const auto& shard : shards) count += shard->sessions.size();
+    return count;
+}
+
+size_t SessionEngine::tick() {
+    std::lock_guard<std::mutex> sessionsLock(sessionsMtx);
+    for (auto& shard : shards) {
+        shard->cursor.store(0, std::memory_order_relaxed);
+    }
+    tickEvents.store(0, std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> lk(tickMtx);
+    pendingWorkers = workers.size();
+    ++generation;
+    tickCv.notify_all();
+    doneCv.wait(lk, [this] { return pendingWorkers == 0; });
+    return tickEvents.load(std::memory_order_relaxed);
+}
+
+size_t SessionEngine::drainShard(Shard& shard) {
+    const size_t count = shard.sessions.size();
+    size_t events = 0;
+    for (;;) {
+        size_t begin = shard.cursor.fetch_add(kClaimChunk, std::memory_order_relaxed);
+        if (begin >= count) break;
+        size_t end = std::min(count, begin + kClaimChunk);
+        for (size_t i = begin; i < end; ++i) {
+            events += shard.sessions[i]->tick();
+        }
+    }
+    return events;
+}
+
+void SessionEngine::workerLoop(size_t index, bool pin) {
+#if defined(__linux__)
+    if (pin) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(static_cast<int>(index % std::max(1u, std::thread::hardware_concurrency())), &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#else
+    (void)pin;
+#endif
+
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(tickMtx);
+            tickCv.wait(lk, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        // 先处理自己的分片，再按顺序从其他分片窃取剩余的会话
+        size_t events = drainShard(*shards[index]);
+        for (size_t k = 1; k < shards.size(); ++k) {
+            events += drainShard(*shards[(index + k) % shards.size()]);
+        }
+        tickEvents.fetch_add(events, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lk(tickMtx);
+        if (--pendingWorkers == 0) {
+            doneCv.notify_one();
+        }
+    }
+}
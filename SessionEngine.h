@@ -0,0 +1,68 @@
+#ifndef SESSION_ENGINE_H
+#define SESSION_ENGINE_H
+
+#include "BindingTable.h"
+#include "InputSession.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 多会话输入引擎：会话按工作线程分片（每核一个分片），tick() 时所有工作线程
+// 并行处理各自分片中的会话；自己的分片处理完后，从其他分片窃取剩余会话，
+// 使负载不均（部分玩家输入特别多）时也能跑满所有核。
+//
+// 认领以小块为单位，通过分片上的原子游标完成，不加锁；会话之间没有共享的
+// 可变状态，因此吞吐随工作线程数线性增长。
+class SessionEngine {
+public:
+    // workerCount 为 0 时使用硬件线程数；pinWorkers 时把第 i 个工作线程绑定到第 i 个核
+    explicit SessionEngine(size_t workerCount = 0, bool pinWorkers = false);
+    ~SessionEngine();
+
+    SessionEngine(const SessionEngine&) = delete;
+    SessionEngine& operator=(const SessionEngine&) = delete;
+
+    // 创建会话并放入当前最空的分片。不能与 tick 并发（会等待正在进行的 tick）
+    std::shared_ptr<InputSession> createSession(std::shared_ptr<const BindingTable> bindings,
+                                                size_t queueCapacity = 1024);
+    bool destroySession(uint32_t id);
+    std::shared_ptr<InputSession> findSession(uint32_t id) const;
+
+    size_t sessionCount() const;
+    size_t workerCount() const { return workers.size(); }
+
+    // 并行处理所有会话一次，阻塞直到全部完成；返回处理的事件总数
+    size_t tick();
+
+private:
+    struct alignas(64) Shard {
+        std::vector<std::shared_ptr<InputSession>> sessions;
+        std::atomic<size_t> cursor{0}; // 本次 tick 中下一个待认领的会话
+    };
+
+    static constexpr size_t kClaimChunk = 8;
+
+    void workerLoop(size_t index, bool pin);
+    size_t drainShard(Shard& shard);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<std::thread> workers;
+    mutable std::mutex sessionsMtx; // 串行化会话增删与 tick
+    uint32_t nextSessionId = 1;
+
+    // tick 的发起与完成
+    std::mutex tickMtx;
+    std::condition_variable tickCv;
+    std::condition_variable doneCv;
+    uint64_t generation = 0;
+    size_t pendingWorkers = 0;
+    bool stopping = false;
+    std::atomic<size_t> tickEvents{0};
+};
+
+#endif // SESSION_ENGINE_H
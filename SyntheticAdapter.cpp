@@ -0,0 +1,294 @@
+#include "SyntheticAdapter.h"
+#include "InputClock.h"
+#include "InputLog.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+using json = nlohmann::json;
+
+namespace {
+
+// 同时存在的触点数上限：触摸输入按下标分配触点编号 1..kPointerCount
+constexpr uint16_t kPointerCount = 10;
+
+// splitmix64：把 seed 与实例编号混合成互不相关的初始状态
+uint64_t mixSeed(uint64_t seed, uint32_t instanceId) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull * (static_cast<uint64_t>(instanceId) + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+bool parseDevice(const std::string& text, DeviceType& device) {
+    if (text == "Keyboard") device = DeviceType::Keyboard;
+    else if (text == "Touch") device = DeviceType::Touch;
+    else return false;
+    return true;
+}
+
+bool parseEventType(const std::string& text, EventType& type) {
+    for (size_t i = 0; i < kEventTypeCount; ++i) {
+        if (text == eventTypeToString(static_cast<EventType>(i))) {
+            type = static_cast<EventType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::vector<SyntheticInput> SyntheticConfig::defaultInputs() {
+    return {
+        {DeviceType::Keyboard, EventType::Button, 32, 1.0},
+        {DeviceType::Keyboard, EventType::Button, 74, 1.0},
+        {DeviceType::Keyboard, EventType::Directional, 87, 2.0},
+        {DeviceType::Keyboard, EventType::Directional, 83, 2.0},
+        {DeviceType::Keyboard, EventType::Button, 65, 0.5}, // 未绑定
+        {DeviceType::Touch, EventType::Button, 0, 1.0},
+        {DeviceType::Touch, EventType::Button, 1, 1.0},
+        {DeviceType::Touch, EventType::Directional, 1001, 2.0},
+        {DeviceType::Touch, EventType::Directional, 1002, 2.0},
+        {DeviceType::Touch, EventType::TouchDown, 2001, 1.0},
+        {DeviceType::Touch, EventType::TouchMove, 2003, 2.0},
+    };
+}
+
+bool loadSyntheticConfig(const std::string& path, SyntheticConfig& config) {
+    std::ifstream f(path);
+    if (!f.is_open()) {
+        InputLog::instance().message(LogLevel::Error, LogCategory::Device, "Could not open synthetic load file: ",
+                                     path);
+        return false;
+    }
+
+    SyntheticConfig loaded;
+    try {
+        json data = json::parse(f);
+        loaded.seed = data.value("seed", loaded.seed);
+        loaded.eventsPerSecond = data.value("rate", loaded.eventsPerSecond);
+        loaded.batchSize = data.value("batch", loaded.batchSize);
+
+        const std::string arrivals = data.value("arrivals", std::string("poisson"));
+        if (arrivals == "uniform") loaded.arrivals = SyntheticArrivals::Uniform;
+        else if (arrivals != "poisson") {
+            InputLog::instance().message(LogLevel::Warning, LogCategory::Device, "Unknown arrivals, using poisson: ",
+                                         arrivals);
+        }
+        const std::string pacing = data.value("pacing", std::string("realtime"));
+        if (pacing == "max") loaded.pacing = SyntheticPacing::AsFastAsPossible;
+        else if (pacing != "realtime") {
+            InputLog::instance().message(LogLevel::Warning, LogCategory::Device, "Unknown pacing, using realtime: ",
+                                         pacing);
+        }
+        if (data.contains("burst") && data["burst"].is_object()) {
+            const json& burst = data["burst"];
+            loaded.burstLength = burst.value("length", loaded.burstLength);
+            loaded.burstSpacingNanos = static_cast<uint64_t>(burst.value("spacingUs", 0.0) * kNanosPerMicro);
+        }
+
+        if (data.contains("inputs") && data["inputs"].is_array()) {
+            for (const json& entry : data["inputs"]) {
+                SyntheticInput input;
+                const std::string device = entry.value("device", std::string("Keyboard"));
+                const std::string type = entry.value("type", std::string("Button"));
+                if (!parseDevice(device, input.device) || !parseEventType(type, input.type)) {
+                    InputLog::instance().message(LogLevel::Warning, LogCategory::Device,
+                                                 "Ignoring synthetic input: ", entry.dump());
+                    continue;
+                }
+                input.code = entry.value("code", 0);
+                input.weight = entry.value("weight", 1.0);
+                loaded.inputs.push_back(input);
+            }
+        }
+    } catch (json::parse_error& e) {
+        InputLog::instance().message(LogLevel::Error, LogCategory::Device, "Could not parse synthetic load file: ",
+                                     path + "\n" + e.what());
+        return false;
+    } catch (json::type_error& e) {
+        InputLog::instance().message(LogLevel::Error, LogCategory::Device, "Invalid value in synthetic load file: ",
+                                     path + "\n" + e.what());
+        return false;
+    }
+    config = std::move(loaded);
+    return true;
+}
+
+SyntheticAdapter::SyntheticAdapter(const SyntheticConfig& cfg, uint32_t instanceId)
+    : config(cfg), instanceNumber(instanceId) {
+    if (config.inputs.empty()) config.inputs = SyntheticConfig::defaultInputs();
+    if (config.eventsPerSecond <= 0.0) config.eventsPerSecond = 1.0;
+    if (config.burstLength == 0) config.burstLength = 1;
+    if (config.batchSize == 0) config.batchSize = 1;
+
+    double total = 0.0;
+    for (const SyntheticInput& input : config.inputs) {
+        total += input.weight > 0.0 ? input.weight : 0.0;
+        cumulativeWeights.push_back(total);
+    }
+    if (total <= 0.0) {
+        // 权重全为 0 时均匀选取
+        for (size_t i = 0; i < cumulativeWeights.size(); ++i) cumulativeWeights[i] = static_cast<double>(i + 1);
+    }
+
+    // 突发之间的平均间隔：一次突发 burstLength 个事件，扣除突发内部占用的时间
+    const double burstNanos = 1e9 * config.burstLength / config.eventsPerSecond;
+    const double inBurst = static_cast<double>(config.burstSpacingNanos) * (config.burstLength - 1);
+    meanGap = burstNanos > inBurst ? burstNanos - inBurst : 0.0;
+    reset();
+}
+
+SyntheticAdapter::~SyntheticAdapter() {
+    stop();
+}
+
+void SyntheticAdapter::reset() {
+    rng.seed(mixSeed(config.seed, instanceNumber));
+    held.assign(config.inputs.size(), 0);
+    nextOffset = 0.0;
+    burstRemaining = 0;
+    started = false;
+    generated.store(0, std::memory_order_relaxed);
+    scheduleNext();
+}
+
+double SyntheticAdapter::uniform() {
+    // 只使用 mt19937_64 的原始输出（标准规定了其序列），不依赖各标准库实现不同的分布类
+    return static_cast<double>(rng() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void SyntheticAdapter::scheduleNext() {
+    if (burstRemaining > 0) {
+        --burstRemaining;
+        nextOffset += static_cast<double>(config.burstSpacingNanos);
+        return;
+    }
+    const double gap = config.arrivals == SyntheticArrivals::Poisson ? -std::log(1.0 - uniform()) * meanGap : meanGap;
+    nextOffset += gap;
+    burstRemaining = config.burstLength - 1;
+}
+
+uint64_t SyntheticAdapter::elapsed() {
+    const uint64_t now = inputNowNanos();
+    return now > origin ? now - origin : 0;
+}
+
+void SyntheticAdapter::anchor() {
+    if (started) return;
+    origin = config.startTimestamp ? config.startTimestamp : inputNowNanos();
+    started = true;
+}
+
+size_t SyntheticAdapter::generate(EventSink& sink, size_t limit, uint64_t until) {
+    anchor();
+    size_t count = 0;
+    while (count < limit && nextOffset <= static_cast<double>(until)) {
+        emitNext(sink, origin + static_cast<uint64_t>(nextOffset));
+        scheduleNext();
+        ++count;
+    }
+    generated.store(generated.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    return count;
+}
+
+void SyntheticAdapter::emitNext(EventSink& sink, uint64_t timestamp) {
+    const double pick = uniform() * cumulativeWeights.back();
+    const size_t index = std::min<size_t>(
+        std::upper_bound(cumulativeWeights.begin(), cumulativeWeights.end(), pick) - cumulativeWeights.begin(),
+        cumulativeWeights.size() - 1);
+    const SyntheticInput& input = config.inputs[index];
+
+    DeviceEvent event{};
+    event.device = input.device;
+    event.type = input.type;
+    event.instanceId = static_cast<uint16_t>(instanceNumber);
+    event.code = input.code;
+    event.timestamp = timestamp;
+
+    // 按键与方向成对按下/松开；触摸按下/抬起交替；移动类输入先按下，之后移动并偶尔抬起
+    uint8_t& down = held[index];
+    switch (input.type) {
+        case EventType::Button:
+            event.value = down ? 0.0f : 1.0f;
+            down = !down;
+            break;
+        case EventType::Directional:
+            event.value = down ? 0.0f : static_cast<float>(0.25 + 0.75 * uniform());
+            down = !down;
+            break;
+        case EventType::TouchDown:
+        case EventType::TouchUp:
+            event.type = down ? EventType::TouchUp : EventType::TouchDown;
+            event.value = down ? 0.0f : 1.0f;
+            down = !down;
+            break;
+        case EventType::TouchMove:
+            if (!down) {
+                event.type = EventType::TouchDown;
+                event.value = 1.0f;
+                down = 1;
+            } else if (uniform() < 0.1) {
+                event.type = EventType::TouchUp;
+                event.value = 0.0f;
+                down = 0;
+            } else {
+                event.value = 1.0f;
+            }
+            break;
+    }
+    if (event.device == DeviceType::Touch && input.type != EventType::Button && input.type != EventType::Directional) {
+        event.pointerId = static_cast<uint16_t>(index % kPointerCount + 1);
+        event.x = static_cast<float>(uniform());
+        event.y = static_cast<float>(uniform());
+    }
+    sink.push(event);
+}
+
+void SyntheticAdapter::pollInto(EventSink& sink) {
+    if (!enabled || running()) return;
+    if (config.pacing == SyntheticPacing::AsFastAsPossible) {
+        generate(sink, config.batchSize, UINT64_MAX);
+    } else {
+        anchor(); // 以第一次轮询的时刻为零点
+        generate(sink, config.batchSize, elapsed());
+    }
+}
+
+void SyntheticAdapter::start(EventSink& target) {
+    if (worker.joinable()) return;
+    stopping.store(false, std::memory_order_relaxed);
+    worker = std::thread(&SyntheticAdapter::run, this, &target);
+}
+
+void SyntheticAdapter::stop() {
+    if (!worker.joinable()) return;
+    stopping.store(true, std::memory_order_relaxed);
+    worker.join();
+}
+
+void SyntheticAdapter::run(EventSink* target) {
+    anchor();
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (!enabled) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        if (config.pacing == SyntheticPacing::AsFastAsPossible) {
+            generate(*target, config.batchSize, UINT64_MAX);
+            continue;
+        }
+        if (generate(*target, config.batchSize, elapsed()) > 0) continue;
+        // 下一个事件还未到期：较长的间隔睡眠（最多 1ms，以便及时响应 stop），较短的让出时间片
+        const double wait = nextOffset - static_cast<double>(elapsed());
+        if (wait > 100.0 * kNanosPerMicro) {
+            const double capped = std::min(wait, static_cast<double>(kNanosPerMilli));
+            std::this_thread::sleep_for(std::chrono::nanoseconds(static_cast<uint64_t>(capped)));
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
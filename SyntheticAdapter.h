@@ -0,0 +1,112 @@
+#ifndef SYNTHETIC_ADAPTER_H
+#define SYNTHETIC_ADAPTER_H
+
+#include "IDeviceAdapter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 合成输入：一个输入码及其被选中的相对权重。各输入的 device 决定设备混合比例
+struct SyntheticInput {
+    DeviceType device = DeviceType::Keyboard;
+    EventType type = EventType::Button;
+    int code = 0;
+    double weight = 1.0;
+};
+
+// 事件到达的间隔分布
+enum class SyntheticArrivals {
+    Uniform, // 固定间隔
+    Poisson  // 指数分布的间隔（泊松过程）
+};
+
+// 产生节奏
+enum class SyntheticPacing {
+    RealTime,        // 随单调时钟产生已到期的事件
+    AsFastAsPossible // 每批产生 batchSize 条，时间戳按速率推进（虚拟时间，可超前于时钟）
+};
+
+// 合成负载描述。同一 seed、同一实例编号产生的事件序列（输入码、值、时间戳偏移）完全相同
+struct SyntheticConfig {
+    uint64_t seed = 1;
+    double eventsPerSecond = 1000.0;  // 长期平均速率
+    SyntheticArrivals arrivals = SyntheticArrivals::Poisson;
+    uint32_t burstLength = 1;         // 每次突发的事件数（1 表示不突发），平均速率不变
+    uint64_t burstSpacingNanos = 0;   // 突发内相邻事件的间隔
+    SyntheticPacing pacing = SyntheticPacing::RealTime;
+    size_t batchSize = 4096;          // 每次轮询（或线程每批）最多产生的事件数
+    uint64_t startTimestamp = 0;      // 时间戳零点；为 0 时取第一次产生事件的时刻
+    std::vector<SyntheticInput> inputs; // 为空时使用 defaultInputs()
+
+    // bindings.json 中的输入码，混合少量未绑定输入
+    static std::vector<SyntheticInput> defaultInputs();
+};
+
+// 从 JSON 文件读取合成负载描述，失败时输出错误并返回 false。格式：
+//   {"seed": 7, "rate": 1000000, "arrivals": "poisson", "burst": {"length": 8, "spacingUs": 5},
+//    "pacing": "max", "batch": 4096,
+//    "inputs": [{"device": "Keyboard", "type": "Button", "code": 32, "weight": 4}, ...]}
+bool loadSyntheticConfig(const std::string& path, SyntheticConfig& config);
+
+// 可复现的合成负载适配器：每个实例自带随机数发生器与状态，按配置的速率、
+// 到达分布、突发与输入码分布产生事件（按键/方向成对按下松开，触摸带触点与位置）。
+// 事件可能来自多种设备，因此不声明设备类型，不受 enableDevice 影响。
+//
+// 既可以像普通适配器一样被轮询，也可以 start() 在自己的线程上产生事件写入线程安全的
+// 接收端（如 DeviceManager 的 InputStreamSink），多个实例并发运行以压满流水线。
+class SyntheticAdapter : public IDeviceAdapter {
+public:
+    explicit SyntheticAdapter(const SyntheticConfig& config = SyntheticConfig{}, uint32_t instanceId = 0);
+    ~SyntheticAdapter() override;
+
+    SyntheticAdapter(const SyntheticAdapter&) = delete;
+    SyntheticAdapter& operator=(const SyntheticAdapter&) = delete;
+
+    // 线程运行期间不产生事件（事件经 start() 的接收端输出）
+    void pollInto(EventSink& sink) override;
+
+    // 在自己的线程上持续产生事件写入 target，直到 stop()。target 必须可在其他线程写入
+    void start(EventSink& target);
+    void stop();
+    bool running() const { return worker.joinable(); }
+
+    // 从头重新产生同一序列（不能在线程运行时调用）
+    void reset();
+
+    uint32_t instance() const { return instanceNumber; }
+    const SyntheticConfig& getConfig() const { return config; }
+    uint64_t generatedCount() const { return generated.load(std::memory_order_relaxed); }
+
+private:
+    // 确定时间戳零点（第一次产生事件时）
+    void anchor();
+    // 产生最多 limit 条时间戳偏移不超过 until 的事件，返回产生的数量
+    size_t generate(EventSink& sink, size_t limit, uint64_t until);
+    void emitNext(EventSink& sink, uint64_t timestamp);
+    void scheduleNext();
+    double uniform(); // [0, 1)
+    uint64_t elapsed(); // 当前时刻相对零点的偏移（RealTime 节奏）
+    void run(EventSink* target);
+
+    SyntheticConfig config;
+    uint32_t instanceNumber;
+    std::vector<double> cumulativeWeights;
+    std::vector<uint8_t> held; // 每个输入当前是否按下（按键、方向、触摸）
+
+    std::mt19937_64 rng;
+    double nextOffset = 0.0;      // 下一个事件相对零点的纳秒数
+    double meanGap = 0.0;         // 两次突发之间的平均间隔
+    uint32_t burstRemaining = 0;
+    uint64_t origin = 0;          // 时间戳零点
+    bool started = false;
+
+    std::atomic<uint64_t> generated{0};
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+};
+
+#endif // SYNTHETIC_ADAPTER_H
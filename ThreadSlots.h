@@ -0,0 +1,90 @@
+#ifndef THREAD_SLOTS_H
+#define THREAD_SLOTS_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// 每个线程独占一个槽位的注册表（指标分片、日志环等）。
+// 线程第一次访问时认领槽位：优先接手已退出线程归还的槽位，否则新建一个；
+// 线程退出时归还，槽位中已有的数据保留，由接手的线程继续使用。
+// 槽位只增不减、地址不变，forEach 可在任意线程遍历全部槽位。
+//
+// 当前线程的槽位按 T 保存在 thread_local 中，因此每个 T 只能有一个注册表实例，
+// 且实例应比所有访问它的线程活得更久（通常是单例的成员或函数内静态变量）。
+template <typename T>
+class ThreadSlots {
+public:
+    ThreadSlots() = default;
+    ThreadSlots(const ThreadSlots&) = delete;
+    ThreadSlots& operator=(const ThreadSlots&) = delete;
+
+    // 当前线程已认领的槽位；尚未认领（或线程正在退出）时返回 nullptr。
+    // 只读一次 thread_local 指针，热路径可内联调用而不需要注册表实例
+    static T* claimed() {
+        Slot* slot = current;
+        return slot ? &slot->value : nullptr;
+    }
+
+    // 当前线程的槽位，首次调用时认领
+    T& local() {
+        Slot* slot = current;
+        return slot ? slot->value : acquire();
+    }
+
+    // 在注册锁内遍历所有槽位（包括已归还的）
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& slot : slots) fn(slot->value);
+    }
+
+private:
+    struct Slot {
+        T value;
+        std::atomic<bool> owned{false}; // 有线程正在使用；线程退出后可由新线程接手
+    };
+
+    // 线程退出时归还槽位
+    struct Release {
+        Slot* slot = nullptr;
+        ~Release() {
+            if (slot) slot->owned.store(false, std::memory_order_release);
+            current = nullptr;
+        }
+    };
+
+    T& acquire() {
+        Slot* chosen = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& slot : slots) {
+                bool expected = false;
+                if (!slot->owned.load(std::memory_order_relaxed) &&
+                    slot->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    chosen = slot.get();
+                    break;
+                }
+            }
+            if (!chosen) {
+                slots.push_back(std::make_unique<Slot>());
+                chosen = slots.back().get();
+                chosen->owned.store(true, std::memory_order_relaxed);
+            }
+        }
+        release.slot = chosen;
+        current = chosen;
+        return chosen->value;
+    }
+
+    // current 没有析构函数，热路径读取不经过 thread_local 的初始化检查；
+    // release 只在认领时访问，负责线程退出时的归还
+    static inline thread_local Slot* current = nullptr;
+    static inline thread_local Release release;
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Slot>> slots;
+};
+
+#endif // THREAD_SLOTS_H
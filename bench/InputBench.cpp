@@ -0,0 +1,722 @@
+// 输入流水线基准测试
+//
+// 用法: input_bench [--events N] [--adapters N] [--strategies M] [--iterations N]
+//                   [--seed S] [--bindings path] [--replay file] [--synthetic file]
+//                   [--filter name] [--sessions N] [--workers 1,2,4] [--json [path]]
+//
+// --replay 使用录制文件（见 InputRecording.h）代替随机合成的事件流；
+// --synthetic 使用合成负载描述（见 SyntheticAdapter.h）产生事件流，--seed 覆盖其中的 seed。
+// saturate 用例让 --adapters 个 SyntheticAdapter 各自在线程上全速产生事件，测量端到端吞吐。
+// sessions 用例对每个工作线程数各报告一行，用于验证多会话引擎的扩展性；
+// analog 用例对 CPU 支持的每个指令集级别各报告一行。
+//
+// 每个用例报告 events/sec、ns/event 与 allocs/event；--json 输出便于跨版本对比。
+
+#include "ActionMap.h"
+#include "AllocationCounter.h"
+#include "AnalogConditioner.h"
+#include "ConflictResolver.h"
+#include "DeviceManager.h"
+#include "EventBatch.h"
+#include "EventCoalescer.h"
+#include "IDeviceAdapter.h"
+#include "InputHistory.h"
+#include "InputLog.h"
+#include "InputProcessor.h"
+#include "ReplayAdapter.h"
+#include "SessionEngine.h"
+#include "SyntheticAdapter.h"
+#include "nlohmann/json.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct BenchConfig {
+    size_t events = 100000;
+    size_t adapters = 4;
+    size_t strategies = 3;
+    size_t iterations = 5;
+    uint32_t seed = 42;
+    std::string bindings = "bindings.json";
+    std::string replay; // 非空时从录制文件读取事件流
+    std::string synthetic; // 非空时按合成负载描述产生事件流
+    std::string filter;
+    size_t sessions = 1000;
+    std::vector<size_t> workers; // 为空时按 1, 2, 4 ... 直到硬件线程数
+    bool json = false;
+    std::string jsonPath; // 为空时输出到 stdout
+};
+
+struct BenchResult {
+    std::string name;
+    size_t events = 0;
+    double seconds = 0.0;
+    uint64_t allocations = 0;
+
+    double eventsPerSecond() const { return seconds > 0 ? events / seconds : 0.0; }
+    double nsPerEvent() const { return events ? seconds * 1e9 / events : 0.0; }
+    double allocationsPerEvent() const { return events ? static_cast<double>(allocations) / events : 0.0; }
+};
+
+// 合成事件流：按绑定表中已有的输入码混合少量未绑定输入，时间戳单调递增
+std::vector<DeviceEvent> makeSyntheticStream(size_t count, uint32_t seed) {
+    struct Source { DeviceType device; EventType type; int code; };
+    static const Source sources[] = {
+        {DeviceType::Keyboard, EventType::Button, 32},
+        {DeviceType::Keyboard, EventType::Button, 74},
+        {DeviceType::Keyboard, EventType::Directional, 87},
+        {DeviceType::Keyboard, EventType::Directional, 83},
+        {DeviceType::Keyboard, EventType::Button, 65}, // 未绑定
+        {DeviceType::Touch, EventType::Button, 0},
+        {DeviceType::Touch, EventType::Button, 1},
+        {DeviceType::Touch, EventType::Directional, 1001},
+        {DeviceType::Touch, EventType::Directional, 1002},
+        {DeviceType::Touch, EventType::TouchDown, 2001},
+        {DeviceType::Touch, EventType::TouchUp, 2002},
+    };
+    constexpr size_t sourceCount = sizeof(sources) / sizeof(sources[0]);
+
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> pick(0, sourceCount - 1);
+    std::uniform_int_distribution<uint64_t> gap(100, 2000);
+
+    std::vector<DeviceEvent> events(count);
+    uint64_t timestamp = 1;
+    for (DeviceEvent& event : events) {
+        const Source& src = sources[pick(gen)];
+        event = DeviceEvent{};
+        event.device = src.device;
+        event.type = src.type;
+        event.code = src.code;
+        event.value = src.type == EventType::TouchUp ? 0.0f : 1.0f;
+        timestamp += gap(gen);
+        event.timestamp = timestamp;
+    }
+    return events;
+}
+
+// 基准输入流：优先使用录制文件（循环拼接到 count 条），否则生成合成事件
+std::vector<DeviceEvent> loadStream(const BenchConfig& config, size_t count, uint32_t seed) {
+    if (!config.synthetic.empty()) {
+        SyntheticConfig load;
+        if (loadSyntheticConfig(config.synthetic, load)) {
+            load.seed = seed;
+            load.pacing = SyntheticPacing::AsFastAsPossible;
+            load.startTimestamp = 1;
+            SyntheticAdapter adapter(load);
+            std::vector<DeviceEvent> events;
+            events.reserve(count + load.batchSize);
+            VectorEventSink sink(events);
+            while (events.size() < count) adapter.pollInto(sink);
+            events.resize(count);
+            return events;
+        }
+        std::cerr << "Warning: bad synthetic load file, falling back to built-in stream" << std::endl;
+    }
+    if (config.replay.empty()) {
+        return makeSyntheticStream(count, seed);
+    }
+    ReplayAdapter replay;
+    std::vector<DeviceEvent> recorded;
+    if (replay.open(config.replay)) {
+        replay.setSpeed(ReplaySpeed::AsFastAsPossible);
+        VectorEventSink sink(recorded);
+        while (!replay.finished()) replay.pollInto(sink);
+    }
+    if (recorded.empty()) {
+        std::cerr << "Warning: empty replay, falling back to synthetic stream" << std::endl;
+        return makeSyntheticStream(count, seed);
+    }
+
+    std::vector<DeviceEvent> events;
+    events.reserve(count);
+    const uint64_t span = recorded.back().timestamp - recorded.front().timestamp + 1;
+    for (uint64_t lap = 0; events.size() < count; ++lap) {
+        for (size_t i = 0; i < recorded.size() && events.size() < count; ++i) {
+            DeviceEvent event = recorded[i];
+            event.timestamp += lap * span;
+            events.push_back(event);
+        }
+    }
+    return events;
+}
+
+// 每次轮询回放一段预生成事件的适配器
+class StreamAdapter : public IDeviceAdapter {
+public:
+    StreamAdapter(std::vector<DeviceEvent> events, size_t perPoll)
+        : events(std::move(events)), perPoll(perPoll) {}
+
+    void pollInto(EventSink& sink) override {
+        for (size_t i = 0; i < perPoll && !events.empty(); ++i) {
+            sink.push(events[cursor]);
+            cursor = (cursor + 1) % events.size();
+        }
+    }
+
+private:
+    std::vector<DeviceEvent> events;
+    size_t perPoll;
+    size_t cursor = 0;
+};
+
+// 执行 iterations 次 body，取耗时最短的一次；body 返回本次处理的事件数
+BenchResult runBench(const std::string& name, const BenchConfig& config,
+                     const std::function<size_t()>& body) {
+    body(); // 预热，让各级缓冲达到稳态容量
+
+    BenchResult best;
+    best.name = name;
+    for (size_t i = 0; i < config.iterations; ++i) {
+        uint64_t allocBefore = AllocationCounter::count();
+        auto start = std::chrono::steady_clock::now();
+        size_t events = body();
+        auto stop = std::chrono::steady_clock::now();
+        uint64_t allocAfter = AllocationCounter::count();
+
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        if (i == 0 || seconds < best.seconds) {
+            best.events = events;
+            best.seconds = seconds;
+            best.allocations = allocAfter - allocBefore;
+        }
+    }
+    return best;
+}
+
+// 防止编译器把被测代码优化掉
+volatile size_t gSink = 0;
+
+void noopHandler(void*, const ActionCommand& command) { gSink = gSink + command.action; }
+
+BenchResult benchActionMapLookup(const BenchConfig& config) {
+    const ActionMap& actionMap = ActionMap::instance();
+    std::vector<DeviceEvent> stream = loadStream(config, config.events, config.seed);
+    return runBench("ActionMap::getActionIds", config, [&]() {
+        size_t found = 0;
+        for (const DeviceEvent& event : stream) {
+            found += actionMap.getActionIds(event).size();
+        }
+        gSink = gSink + found;
+        return stream.size();
+    });
+}
+
+BenchResult benchActionMapLookupCompat(const BenchConfig& config) {
+    const ActionMap& actionMap = ActionMap::instance();
+    std::vector<DeviceEvent> stream = loadStream(config, config.events, config.seed);
+    return runBench("ActionMap::getActions", config, [&]() {
+        size_t found = 0;
+        for (const DeviceEvent& event : stream) {
+            found += actionMap.getActions(event).size();
+        }
+        gSink = gSink + found;
+        return stream.size();
+    });
+}
+
+BenchResult benchDeviceManagerPoll(const BenchConfig& config) {
+    DeviceManager& deviceManager = DeviceManager::instance();
+    const size_t adapterCount = config.adapters ? config.adapters : 1;
+    // 每帧每个适配器 64 个事件，总事件数约为 config.events
+    const size_t perPoll = 64;
+    const size_t frames = std::max<size_t>(1, config.events / (perPoll * adapterCount));
+
+    std::vector<std::shared_ptr<IDeviceAdapter>> adapters;
+    for (size_t i = 0; i < adapterCount; ++i) {
+        adapters.push_back(std::make_shared<StreamAdapter>(
+            loadStream(config, perPoll * 16, config.seed + static_cast<uint32_t>(i)), perPoll));
+        deviceManager.registerAdapter(adapters.back());
+    }
+
+    std::vector<DeviceEvent> frame;
+    BenchResult result = runBench(
+        "DeviceManager::pollEvents x" + std::to_string(adapterCount) + " adapters", config, [&]() {
+            size_t total = 0;
+            for (size_t f = 0; f < frames; ++f) {
+                deviceManager.pollEvents(frame);
+                total += frame.size();
+            }
+            return total;
+        });
+
+    for (const auto& adapter : adapters) {
+        deviceManager.unregisterAdapter(adapter);
+    }
+    return result;
+}
+
+BenchResult benchConflictResolver(const BenchConfig& config) {
+    ConflictResolver resolver;
+    for (size_t i = 0; i < config.strategies; ++i) {
+        switch (i % 3) {
+            case 0: resolver.addStrategy(std::make_shared<TouchVsDirectionalStrategy>()); break;
+            case 1: resolver.addStrategy(std::make_shared<LastInputWinsStrategy>()); break;
+            case 2:
+                resolver.addStrategy(std::make_shared<DevicePriorityStrategy>(DeviceType::Touch,
+                                                                              DeviceType::Keyboard));
+                break;
+        }
+    }
+    std::vector<DeviceEvent> stream = loadStream(config, config.events, config.seed);
+    return runBench("ConflictResolver::admit x" + std::to_string(config.strategies) +
+                        " strategies",
+                    config, [&]() {
+                        size_t passed = 0;
+                        for (const DeviceEvent& event : stream) {
+                            passed += resolver.admit(event) ? 1 : 0;
+                        }
+                        gSink = gSink + passed;
+                        return stream.size();
+                    });
+}
+
+BenchResult benchInputProcessor(const BenchConfig& config) {
+    InputProcessor processor(ActionMap::instance());
+    processor.getCommandHandlers().setDefaultHandler(&noopHandler);
+    processor.addConflictStrategy(std::make_shared<TouchVsDirectionalStrategy>());
+    std::vector<DeviceEvent> stream = loadStream(config, config.events, config.seed);
+    return runBench("InputProcessor::processInput", config, [&]() {
+        processor.processInput(stream);
+        return stream.size();
+    });
+}
+
+// 延迟执行：输入线程生成命令写入队列，另一个线程（游戏线程）持续成批取出执行。
+// 使用 Wait 背压，结果包含队列满时输入线程的等待
+BenchResult benchInputProcessorDeferred(const BenchConfig& config) {
+    InputProcessor processor(ActionMap::instance());
+    processor.getCommandHandlers().setDefaultHandler(&noopHandler);
+    processor.addConflictStrategy(std::make_shared<TouchVsDirectionalStrategy>());
+    processor.setDispatchMode(DispatchMode::Deferred, 4096, BackpressurePolicy::Wait);
+    std::vector<DeviceEvent> stream = loadStream(config, config.events, config.seed);
+
+    std::atomic<bool> stop{false};
+    std::thread gameThread([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (processor.dispatchCommands(256) == 0) std::this_thread::yield();
+        }
+        while (processor.dispatchCommands() != 0) {
+        }
+    });
+    BenchResult result = runBench("InputProcessor::processInput (deferred)", config, [&]() {
+        processor.processInput(stream);
+        return stream.size();
+    });
+    stop = true;
+    gameThread.join();
+    return result;
+}
+
+// 回滚：事件按每帧 64 个经 InputHistory 处理，每次回到 8 帧之前重新模拟到最新帧
+BenchResult benchRollback(const BenchConfig& config) {
+    constexpr size_t kEventsPerFrame = 64;
+    constexpr size_t kRollbackFrames = 8;
+    InputProcessor processor(ActionMap::instance());
+    processor.getCommandHandlers().setDefaultHandler(&noopHandler);
+    processor.addConflictStrategy(std::make_shared<TouchVsDirectionalStrategy>());
+    std::vector<DeviceEvent> stream = loadStream(config, config.events, config.seed);
+
+    InputHistory history(64);
+    std::vector<DeviceEvent> frame;
+    for (size_t i = 0; i < stream.size(); i += kEventsPerFrame) {
+        frame.assign(stream.begin() + i, stream.begin() + std::min(stream.size(), i + kEventsPerFrame));
+        history.process(processor, frame);
+    }
+    const uint64_t from = history.latestFrame() + 1 - std::min<size_t>(kRollbackFrames, history.size());
+    return runBench("InputHistory::resimulate (" + std::to_string(kRollbackFrames) + " frames)", config, [&]() {
+        size_t events = 0;
+        history.resimulate(processor, from, [&](uint64_t, std::vector<DeviceEvent>& e) { events += e.size(); });
+        return events;
+    });
+}
+
+// 合成负载的产生速度（单线程，全速）
+BenchResult benchSyntheticAdapter(const BenchConfig& config) {
+    SyntheticConfig load;
+    load.seed = config.seed;
+    load.pacing = SyntheticPacing::AsFastAsPossible;
+    load.batchSize = 1024;
+    load.burstLength = 8;
+    SyntheticAdapter adapter(load);
+    std::vector<DeviceEvent> events;
+    events.reserve(load.batchSize);
+    return runBench("SyntheticAdapter::pollInto", config, [&]() {
+        size_t produced = 0;
+        while (produced < config.events) {
+            events.clear();
+            VectorEventSink sink(events);
+            adapter.pollInto(sink);
+            produced += events.size();
+        }
+        gSink = gSink + events.back().code;
+        return produced;
+    });
+}
+
+// 多个合成适配器在各自线程上全速写入同一个输入环，消费者线程成批取出处理，
+// 测量流水线被压满时的吞吐（环满时生产者丢弃新事件）
+BenchResult benchSaturate(const BenchConfig& config) {
+    class RingSink : public EventSink {
+    public:
+        explicit RingSink(EventRing& ring) : ring(ring) {}
+        void push(const DeviceEvent& event) override { ring.push(event); }
+
+    private:
+        EventRing& ring;
+    };
+
+    InputProcessor processor(ActionMap::instance());
+    processor.getCommandHandlers().setDefaultHandler(&noopHandler);
+    processor.addConflictStrategy(std::make_shared<TouchVsDirectionalStrategy>());
+    EventRing ring(1 << 16, OverflowPolicy::DropNewest);
+    RingSink sink(ring);
+
+    const size_t producers = std::max<size_t>(1, config.adapters);
+    std::vector<std::unique_ptr<SyntheticAdapter>> adapters;
+    for (size_t i = 0; i < producers; ++i) {
+        SyntheticConfig load;
+        load.seed = config.seed;
+        load.pacing = SyntheticPacing::AsFastAsPossible;
+        load.batchSize = 256;
+        adapters.push_back(std::make_unique<SyntheticAdapter>(load, static_cast<uint32_t>(i)));
+        adapters.back()->start(sink);
+    }
+
+    std::vector<DeviceEvent> frame;
+    frame.reserve(ring.capacity());
+    BenchResult result = runBench("InputProcessor <- SyntheticAdapter x" + std::to_string(producers) + " threads",
+                                  config, [&]() {
+                                      size_t processed = 0;
+                                      while (processed < config.events) {
+                                          frame.clear();
+                                          ring.drain([&](const DeviceEvent& event) { frame.push_back(event); });
+                                          if (frame.empty()) continue;
+                                          processor.processInput(frame);
+                                          processed += frame.size();
+                                      }
+                                      return processed;
+                                  });
+    for (auto& adapter : adapters) adapter->stop();
+    return result;
+}
+
+BenchResult benchEventCoalescer(const BenchConfig& config) {
+    EventCoalescer coalescer;
+    coalescer.setDefaultPolicy(EventType::Directional, CoalescePolicy::KeepLatest);
+    const std::vector<DeviceEvent> stream = loadStream(config, config.events, config.seed);
+    // 按 256 个事件为一帧合并
+    const size_t frameSize = 256;
+    std::vector<DeviceEvent> frame;
+    frame.reserve(frameSize);
+    return runBench("EventCoalescer::coalesce (KeepLatest)", config, [&]() {
+        size_t kept = 0;
+        for (size_t begin = 0; begin < stream.size(); begin += frameSize) {
+            size_t end = std::min(stream.size(), begin + frameSize);
+            frame.assign(stream.begin() + begin, stream.begin() + end);
+            kept += coalescer.coalesce(frame);
+        }
+        gSink = gSink + kept;
+        return stream.size();
+    });
+}
+
+// 同样的合并，但帧以 EventBatch（SoA）形式经过合并与冲突裁决，最后一次性导出
+BenchResult benchEventCoalescerBatch(const BenchConfig& config) {
+    EventCoalescer coalescer;
+    coalescer.setDefaultPolicy(EventType::Directional, CoalescePolicy::KeepLatest);
+    ConflictEngine engine;
+    ConflictRule rule;
+    rule.kind = ConflictRuleKind::TouchGate;
+    engine.addRule(rule);
+    const std::vector<DeviceEvent> stream = loadStream(config, config.events, config.seed);
+    const size_t frameSize = 256;
+    EventBatch batch;
+    batch.reserve(frameSize);
+    std::vector<DeviceEvent> frame;
+    frame.reserve(frameSize);
+    return runBench("EventCoalescer::coalesce (EventBatch) + admitBatch", config, [&]() {
+        size_t kept = 0;
+        for (size_t begin = 0; begin < stream.size(); begin += frameSize) {
+            size_t end = std::min(stream.size(), begin + frameSize);
+            batch.assign(stream.data() + begin, end - begin);
+            coalescer.coalesce(batch);
+            engine.admitBatch(batch);
+            kept += batch.exportTo(frame);
+        }
+        gSink = gSink + kept;
+        return stream.size();
+    });
+}
+
+// 日志：类别关闭时的写入代价，以及开启时写入 + 后台格式化（输出到空流）的总代价
+std::vector<BenchResult> benchInputLog(const BenchConfig& config) {
+    const std::vector<DeviceEvent> stream = loadStream(config, config.events, config.seed);
+    InputLog& log = InputLog::instance();
+    std::ostream nullStream(nullptr);
+    log.setOutput(nullStream, nullStream);
+    const ActionId action = 0;
+
+    std::vector<BenchResult> results;
+    log.setLevel(LogCategory::Input, LogLevel::Off);
+    results.push_back(runBench("InputLog::event (category off)", config, [&]() {
+        for (const DeviceEvent& event : stream) {
+            log.event(LogLevel::Info, LogCategory::Input, "收到事件: ", event, &action, 1);
+        }
+        return stream.size();
+    }));
+
+    // 每 256 条 flush 一次，保证环不会写满而丢弃
+    log.setLevel(LogCategory::Input, LogLevel::Info);
+    log.start();
+    results.push_back(runBench("InputLog::event + format", config, [&]() {
+        for (size_t i = 0; i < stream.size(); ++i) {
+            log.event(LogLevel::Info, LogCategory::Input, "收到事件: ", stream[i], &action, 1);
+            if ((i & 255) == 255) log.flush();
+        }
+        log.flush();
+        return stream.size();
+    }));
+    log.stop();
+    log.setOutput(std::cout, std::cerr);
+    return results;
+}
+
+// 模拟量调理：64 个手柄、每个两根摇杆（4 个轴），1kHz 采样，径向死区 + 1-euro 平滑
+BenchResult benchAnalogConditioner(const BenchConfig& config, SimdLevel level) {
+    const int axisCount = 256;
+    AnalogConditioner conditioner;
+    conditioner.setSimdLevel(level);
+    for (int code = 0; code < axisCount; ++code) {
+        AnalogProfile profile;
+        profile.deadzone = 0.12f;
+        profile.outerDeadzone = 0.95f;
+        profile.curve = 0.4f;
+        profile.radialPair = code ^ 1;
+        profile.smoothing = AnalogSmoothing::OneEuro;
+        profile.beta = 0.05f;
+        conditioner.setProfile(DeviceType::Touch, code, profile);
+    }
+
+    std::mt19937 gen(config.seed);
+    std::uniform_real_distribution<float> noise(-0.02f, 0.02f);
+    std::vector<DeviceEvent> stream(config.events);
+    for (size_t i = 0; i < stream.size(); ++i) {
+        DeviceEvent& event = stream[i];
+        event = DeviceEvent{};
+        event.device = DeviceType::Touch;
+        event.type = EventType::Directional;
+        event.code = static_cast<int>(i % axisCount);
+        event.timestamp = 1 + i * kNanosPerMilli / axisCount;
+        event.value = std::sin(static_cast<float>(i / axisCount) * 0.01f + event.code) + noise(gen);
+    }
+
+    // 按 16ms 一帧（每个轴 16 个采样）调理
+    const size_t frameSize = axisCount * 16;
+    std::vector<DeviceEvent> frame;
+    frame.reserve(frameSize);
+    return runBench(std::string("AnalogConditioner::condition (") + simdLevelToString(level) + ")", config, [&]() {
+        conditioner.reset();
+        size_t conditioned = 0;
+        for (size_t begin = 0; begin < stream.size(); begin += frameSize) {
+            size_t end = std::min(stream.size(), begin + frameSize);
+            frame.assign(stream.begin() + begin, stream.begin() + end);
+            conditioned += conditioner.condition(frame);
+        }
+        gSink = gSink + conditioned;
+        return stream.size();
+    });
+}
+
+// 多会话引擎：每个会话挂一个事件源，每次 tick 每个会话处理 perTick 个事件
+BenchResult benchSessionEngine(const BenchConfig& config, size_t workerCount) {
+    const size_t perTick = 16;
+    // 每个会话的回调写自己的计数器（按缓存行对齐），避免工作线程之间互相干扰
+    struct alignas(64) SessionCounter { size_t commands = 0; };
+    std::vector<SessionCounter> counters(config.sessions);
+    SessionEngine engine(workerCount);
+    std::shared_ptr<const BindingTable> bindings = ActionMap::instance().shareBindings();
+    for (size_t i = 0; i < config.sessions; ++i) {
+        std::shared_ptr<InputSession> session = engine.createSession(bindings);
+        session->setSource(std::make_shared<StreamAdapter>(
+            makeSyntheticStream(256, config.seed + static_cast<uint32_t>(i)), perTick));
+        session->getConflictResolver().addStrategy(std::make_shared<TouchVsDirectionalStrategy>());
+        session->getCommandHandlers().setDefaultHandler(
+            [](void* context, const ActionCommand&) { ++static_cast<SessionCounter*>(context)->commands; },
+            &counters[i]);
+    }
+    const size_t ticks = std::max<size_t>(1, config.events / std::max<size_t>(1, config.sessions * perTick));
+    return runBench("SessionEngine::tick " + std::to_string(config.sessions) + " sessions x" +
+                        std::to_string(engine.workerCount()) + " workers",
+                    config, [&]() {
+                        size_t total = 0;
+                        for (size_t t = 0; t < ticks; ++t) total += engine.tick();
+                        gSink = gSink + counters[0].commands;
+                        return total;
+                    });
+}
+
+std::vector<size_t> defaultWorkerCounts() {
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t n = 1; n < hardware; n *= 2) counts.push_back(n);
+    counts.push_back(hardware);
+    return counts;
+}
+
+bool parseArgs(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* value = nullptr;
+        if (arg == "--json") {
+            config.json = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') config.jsonPath = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if ((value = next()) == nullptr) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        } else if (arg == "--events") {
+            config.events = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--adapters") {
+            config.adapters = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--strategies") {
+            config.strategies = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--iterations") {
+            config.iterations = std::max<size_t>(1, std::strtoull(value, nullptr, 10));
+        } else if (arg == "--seed") {
+            config.seed = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        } else if (arg == "--bindings") {
+            config.bindings = value;
+        } else if (arg == "--replay") {
+            config.replay = value;
+        } else if (arg == "--synthetic") {
+            config.synthetic = value;
+        } else if (arg == "--filter") {
+            config.filter = value;
+        } else if (arg == "--sessions") {
+            config.sessions = std::max<size_t>(1, std::strtoull(value, nullptr, 10));
+        } else if (arg == "--workers") {
+            config.workers.clear();
+            for (const char* p = value; *p;) {
+                char* end = nullptr;
+                size_t n = std::strtoull(p, &end, 10);
+                if (end == p) break;
+                if (n > 0) config.workers.push_back(n);
+                p = *end == ',' ? end + 1 : end;
+            }
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void printText(const std::vector<BenchResult>& results) {
+    std::printf("%-52s %12s %14s %10s %12s\n", "benchmark", "events", "events/sec", "ns/event",
+                "allocs/event");
+    for (const BenchResult& r : results) {
+        std::printf("%-52s %12zu %14.0f %10.2f %12.4f\n", r.name.c_str(), r.events,
+                    r.eventsPerSecond(), r.nsPerEvent(), r.allocationsPerEvent());
+    }
+}
+
+void printJson(const std::vector<BenchResult>& results, const BenchConfig& config) {
+    nlohmann::json doc;
+    doc["config"] = {{"events", config.events},         {"adapters", config.adapters},
+                     {"strategies", config.strategies}, {"iterations", config.iterations},
+                     {"seed", config.seed},             {"sessions", config.sessions}};
+    doc["results"] = nlohmann::json::array();
+    for (const BenchResult& r : results) {
+        doc["results"].push_back({{"name", r.name},
+                                  {"events", r.events},
+                                  {"seconds", r.seconds},
+                                  {"events_per_sec", r.eventsPerSecond()},
+                                  {"ns_per_event", r.nsPerEvent()},
+                                  {"allocs_per_event", r.allocationsPerEvent()}});
+    }
+    if (config.jsonPath.empty()) {
+        std::cout << doc.dump(2) << std::endl;
+    } else {
+        std::ofstream out(config.jsonPath);
+        out << doc.dump(2) << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        std::cerr << "Usage: input_bench [--events N] [--adapters N] [--strategies M]"
+                     " [--iterations N] [--seed S] [--bindings path] [--replay file]"
+                     " [--synthetic file] [--filter name] [--sessions N] [--workers 1,2,4]"
+                     " [--json [path]]" << std::endl;
+        return 1;
+    }
+
+    ActionMap::instance().initialize(config.bindings);
+    if (ActionMap::instance().actionCount() == 0) {
+        std::cerr << "No actions loaded from " << config.bindings << std::endl;
+        return 1;
+    }
+
+    using BenchFn = BenchResult (*)(const BenchConfig&);
+    const std::pair<const char*, BenchFn> benches[] = {
+        {"lookup", &benchActionMapLookup},
+        {"lookup_compat", &benchActionMapLookupCompat},
+        {"poll", &benchDeviceManagerPoll},
+        {"conflict", &benchConflictResolver},
+        {"coalesce", &benchEventCoalescer},
+        {"coalesce_batch", &benchEventCoalescerBatch},
+        {"process", &benchInputProcessor},
+        {"process_deferred", &benchInputProcessorDeferred},
+        {"rollback", &benchRollback},
+        {"synthetic", &benchSyntheticAdapter},
+        {"saturate", &benchSaturate},
+    };
+
+    std::vector<BenchResult> results;
+    for (const auto& [key, fn] : benches) {
+        if (!config.filter.empty() && config.filter != key) continue;
+        results.push_back(fn(config));
+    }
+    if (config.filter.empty() || config.filter == "sessions") {
+        const std::vector<size_t> workerCounts = config.workers.empty() ? defaultWorkerCounts() : config.workers;
+        for (size_t workers : workerCounts) {
+            results.push_back(benchSessionEngine(config, workers));
+        }
+    }
+    if (config.filter.empty() || config.filter == "log") {
+        for (BenchResult& result : benchInputLog(config)) results.push_back(std::move(result));
+    }
+    if (config.filter.empty() || config.filter == "analog") {
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+            if (AnalogKernels::select(level).level != level) continue;
+            results.push_back(benchAnalogConditioner(config, level));
+        }
+    }
+
+    if (config.json) {
+        printJson(results, config);
+    } else {
+        printText(results);
+    }
+    return 0;
+}
@@ -1,44 +1,50 @@
 #include "ActionMap.h"
+#include "AnalogConditioner.h"
 #include "ConflictResolver.h"
 #include "DeviceEvent.h"
 #include "DeviceManager.h"
+#include "EventCoalescer.h"
+#include "InputClock.h"
+#include "InputLog.h"
+#include "InputMetrics.h"
 #include "InputProcessor.h"
+#include "InputTrace.h"
 #include "KeyboardAdapter.h"
 #include "GamepadAdapter.h"
+#include "GestureRecognizer.h"
+#include "InputRecording.h"
+#include "ReplayAdapter.h"
+#include "SyntheticAdapter.h"
+#include <atomic>
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <thread>
 #include <chrono>
 
-// 辅助函数：获取事件对应的操作名称
-std::string getEventActions(const DeviceEvent& event) {
-    auto actions = ActionMap::instance().getActions(event);
-    if (actions.empty()) {
-        return "未知操作";
-    }
-    
-    std::string result;
-    for (size_t i = 0; i < actions.size(); ++i) {
-        if (i > 0) result += ", ";
-        result += actions[i].name;
-    }
-    return result;
-}
-
 // 辅助函数：检查事件是否被冲突解决策略过滤
 bool isEventFiltered(const DeviceEvent& event, const ConflictResolver& resolver) {
     return !resolver.shouldProcessInput(event);
 }
 
 void handleEvents(const std::vector<DeviceEvent>& events,InputProcessor& inputProcessor){
+    InputLog& log = InputLog::instance();
       // 处理每个事件
     for (const auto& event : events) {
       bool isFiltered = isEventFiltered(event, inputProcessor.getConflictResolver());
-      std::cout << "收到事件: " << deviceTypeToString(event.device) 
-                << " -> " << getEventActions(event)
-                << (isFiltered ? " [被冲突策略过滤]" : "") << std::endl;
-      
+      // 只写入定长记录，动作名由日志线程解析
+      if (log.enabled(LogCategory::Input, LogLevel::Info)) {
+        BindingSnapshot bindings = ActionMap::instance().snapshot();
+        ActionIdSpan actions = bindings->lookup(event.device, event.code);
+        const char* note = actions.empty() ? (isFiltered ? "未知操作 [被冲突策略过滤]" : "未知操作")
+                                           : (isFiltered ? " [被冲突策略过滤]" : "");
+        log.event(LogLevel::Info, LogCategory::Input, "收到事件: ", event, actions.begin(), actions.size(), note);
+      }
+
       if (!isFiltered) {
         inputProcessor.processInput(event);
       }
@@ -47,36 +53,40 @@ void handleEvents(const std::vector<DeviceEvent>& events,InputProcessor& inputPr
 
 std::vector<DeviceEvent> getMockedEvents(){
     std::vector<DeviceEvent> events;
-    uint64_t baseTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()
-    ).count();
+    uint64_t baseTime = inputNowNanos();
 
     // 手柄触摸按下
-    DeviceEvent touchDown;
+    DeviceEvent touchDown{};
     touchDown.device = DeviceType::Touch;
     touchDown.type = EventType::TouchDown;
     touchDown.code = 2001;
     touchDown.value = 1.0f;
-    touchDown.timestamp = baseTime + 100;
+    touchDown.pointerId = 1;
+    touchDown.x = 0.5f;
+    touchDown.y = 0.5f;
+    touchDown.timestamp = baseTime + 100 * kNanosPerMilli;
     events.push_back(touchDown);
 
     // 手柄按下上方向键（应该被过滤）
-    DeviceEvent gamepadUp;
+    DeviceEvent gamepadUp{};
     gamepadUp.device = DeviceType::Keyboard;
     gamepadUp.type = EventType::Directional;
     gamepadUp.code = 32;
     gamepadUp.value = 1.0f;
-    gamepadUp.timestamp = baseTime + 200;
+    gamepadUp.timestamp = baseTime + 200 * kNanosPerMilli;
     events.push_back(gamepadUp);
 
     // 手柄触摸抬起
-    DeviceEvent touchUp;
+    DeviceEvent touchUp{};
     touchUp.device = DeviceType::Touch;
     touchUp.type = EventType::TouchUp;
     touchUp.code = 2002;
+    touchUp.pointerId = 1;
+    touchUp.x = 0.5f;
+    touchUp.y = 0.5f;
 
     touchUp.value = 0.0f;
-    touchUp.timestamp = baseTime + 300;
+    touchUp.timestamp = baseTime + 300 * kNanosPerMilli;
     events.push_back(touchUp);
 
     // 手柄再次按下上方向键（应该被处理）
@@ -86,7 +96,87 @@ std::vector<DeviceEvent> getMockedEvents(){
     return events;
 }
 
-int main() {
+// 辅助函数：打印每个动作"采集 -> 执行"的延迟
+void printLatencyReport(InputProcessor& inputProcessor) {
+    BindingSnapshot bindings = ActionMap::instance().snapshot();
+    inputProcessor.getLatencyTracker().forEach(
+        [&](ActionId id, const ActionLatencyTracker::Stats& stats) {
+            if (id >= bindings->actionCount()) return;
+            std::cout << "延迟统计: " << bindings->action(id).name
+                      << " 次数=" << stats.count
+                      << " 平均=" << stats.averageNanos() / kNanosPerMicro << "us"
+                      << " 最大=" << stats.maxNanos / kNanosPerMicro << "us" << std::endl;
+        });
+    if (const CommandQueue* queue = inputProcessor.getCommandQueue()) {
+        CommandQueueStats stats = queue->stats();
+        std::cout << "命令队列: 入队=" << stats.pushed << " 丢弃=" << stats.dropped
+                  << " 最大长度=" << stats.highWatermark << "/" << queue->capacity() << std::endl;
+    }
+    inputProcessor.resetLatencyStats();
+    if (InputMetrics::kEnabled) {
+        std::cout << "流水线指标:\n" << InputMetrics::snapshot().toText();
+    }
+}
+
+// 绑定文件被修改时热重载（新绑定表在游戏线程外构建完毕后原子发布）
+void reloadBindingsIfChanged(const std::string& path,
+                             std::filesystem::file_time_type& lastWrite,
+                             AnalogConditioner& conditioner) {
+  std::error_code ec;
+  auto writeTime = std::filesystem::last_write_time(path, ec);
+  if (ec || writeTime == lastWrite) return;
+  lastWrite = writeTime;
+  if (ActionMap::instance().reload(path)) {
+    std::cout << "\n=== 已热重载绑定: " << path << " ===" << std::endl;
+  }
+  conditioner.loadProfiles(path);
+}
+
+// Ctrl+C 时退出主循环，保证录制文件正常收尾
+std::atomic<bool> running{true};
+void onInterrupt(int) { running = false; }
+
+// 命令行参数：--record <file> 录制原始事件流；--replay <file> [--replay-speed <倍数|max>] 回放；
+// --dispatch deferred 命令经队列在帧末统一执行；--log <trace|debug|info|warning|error|off> 日志级别；
+// --metrics <file> 退出时把流水线指标写为 JSON；--synthetic <file> 用合成负载代替模拟设备
+struct DemoOptions {
+  std::string recordPath;
+  std::string replayPath;
+  std::string replaySpeed;
+  std::string dispatch;
+  std::string logLevel;
+  std::string metricsPath;
+  std::string syntheticPath;
+};
+
+DemoOptions parseOptions(int argc, char **argv) {
+  DemoOptions options;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string arg = argv[i];
+    if (arg == "--record") options.recordPath = argv[i + 1];
+    else if (arg == "--replay") options.replayPath = argv[i + 1];
+    else if (arg == "--replay-speed") options.replaySpeed = argv[i + 1];
+    else if (arg == "--dispatch") options.dispatch = argv[i + 1];
+    else if (arg == "--log") options.logLevel = argv[i + 1];
+    else if (arg == "--metrics") options.metricsPath = argv[i + 1];
+    else if (arg == "--synthetic") options.syntheticPath = argv[i + 1];
+    else std::cerr << "Warning: Unknown option: " << arg << std::endl;
+  }
+  return options;
+}
+
+int main(int argc, char **argv) {
+  DemoOptions options = parseOptions(argc, argv);
+  std::signal(SIGINT, onInterrupt);
+
+  // 日志在后台线程格式化输出，事件与命令的日志不阻塞输入处理
+  LogLevel logLevel = LogLevel::Info;
+  if (!options.logLevel.empty() && !parseLogLevel(options.logLevel, logLevel)) {
+    std::cerr << "Warning: Unknown log level: " << options.logLevel << std::endl;
+  }
+  InputLog::instance().setLevel(logLevel);
+  InputLog::instance().start();
+
   // 1. 初始化核心组件
   ActionMap::instance().initialize("bindings.json");        // 动作映射
   DeviceManager &deviceManager = DeviceManager::instance(); // 设备管理器
@@ -115,10 +205,44 @@ int main() {
   auto mockedEvents = getMockedEvents();
   handleEvents(mockedEvents, inputProcessor);
 
-  // 4. 注册设备适配器
+  // 4. 注册设备适配器，并开启输入延迟追踪
+  InputTrace::setEnabled(true);
   std::cout << "\n--- 注册设备适配器 ---" << std::endl;
-  deviceManager.registerAdapter(std::make_shared<KeyboardAdapter>());
-  deviceManager.registerAdapter(std::make_shared<GamepadAdapter>());
+  if (!options.replayPath.empty()) {
+    // 回放模式：用录制文件代替模拟设备
+    auto replay = std::make_shared<ReplayAdapter>();
+    if (!replay->open(options.replayPath)) {
+      return 1;
+    }
+    if (options.replaySpeed == "max") {
+      replay->setSpeed(ReplaySpeed::AsFastAsPossible);
+    } else if (!options.replaySpeed.empty()) {
+      replay->setSpeed(ReplaySpeed::Scaled, std::atof(options.replaySpeed.c_str()));
+    }
+    std::cout << "回放录制文件: " << options.replayPath << " (" << replay->totalRecords()
+              << " 条记录)" << std::endl;
+    deviceManager.registerAdapter(replay);
+  } else if (!options.syntheticPath.empty()) {
+    // 压力测试：按合成负载描述产生可复现的事件流
+    SyntheticConfig load;
+    if (!loadSyntheticConfig(options.syntheticPath, load)) {
+      return 1;
+    }
+    std::cout << "合成负载: " << options.syntheticPath << " (" << load.eventsPerSecond << " 事件/秒)"
+              << std::endl;
+    deviceManager.registerAdapter(std::make_shared<SyntheticAdapter>(load));
+  } else {
+    deviceManager.registerAdapter(std::make_shared<KeyboardAdapter>());
+    deviceManager.registerAdapter(std::make_shared<GamepadAdapter>());
+  }
+
+  InputRecorder recorder;
+  if (!options.recordPath.empty() && recorder.open(options.recordPath)) {
+    std::cout << "录制原始事件到: " << options.recordPath << std::endl;
+  }
+
+  // 独立的 1kHz 输入采样线程：事件在采集时打上时间戳，游戏线程每帧取出
+  deviceManager.startSampling(1000);
 
   // 5. 主循环：处理设备事件
   std::cout << "\n--- 开始处理设备事件 ---" << std::endl;
@@ -131,14 +255,45 @@ int main() {
   };
   size_t currentDeviceIndex = 0;
   uint64_t lastSwitchTime = 0;
+  std::vector<DeviceEvent> events; // 帧间复用，避免每帧分配
+
+  // 模拟量调理：按 bindings.json 的 "analog" 段对摇杆/方向输入做平滑、死区与响应曲线
+  AnalogConditioner conditioner;
+  conditioner.loadProfiles("bindings.json");
+  std::cout << "模拟量调理: " << conditioner.profileCount() << " 个轴, 指令集 "
+            << simdLevelToString(conditioner.simdLevel()) << std::endl;
 
-  while (true) {
-    uint64_t currentTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-      std::chrono::system_clock::now().time_since_epoch()
-    ).count();
+  // 触摸手势：滑动/缩放/长按作为 Touch 按键（输入码 3001 起）插入事件流，在 bindings.json 中绑定动作
+  GestureRecognizer gestures;
+
+  // 每帧合并冗余的方向输入，只保留最新值；按键与触摸按下/抬起不受影响
+  EventCoalescer coalescer;
+  coalescer.setDefaultPolicy(EventType::Directional, CoalescePolicy::KeepLatest);
+
+  // 延迟执行：输入流水线只生成命令，游戏逻辑在帧末的固定位置成批执行
+  if (options.dispatch == "deferred") {
+    inputProcessor.setDispatchMode(DispatchMode::Deferred);
+    std::cout << "命令执行方式: 帧末统一执行" << std::endl;
+  } else if (!options.dispatch.empty() && options.dispatch != "immediate") {
+    std::cerr << "Warning: Unknown dispatch mode: " << options.dispatch << std::endl;
+  }
+
+  std::error_code ec;
+  auto bindingsWriteTime = std::filesystem::last_write_time("bindings.json", ec);
+  uint64_t lastReloadCheck = 0;
+
+  while (running) {
+    uint64_t currentTime = inputNowNanos();
+
+    // 每秒检查一次绑定文件是否变化
+    if (currentTime - lastReloadCheck >= 1000 * kNanosPerMilli) {
+      reloadBindingsIfChanged("bindings.json", bindingsWriteTime, conditioner);
+      lastReloadCheck = currentTime;
+    }
     
     // 每10秒切换一次设备
-    if (currentTime - lastSwitchTime >= 10000) {
+    if (currentTime - lastSwitchTime >= 10000 * kNanosPerMilli) {
+      printLatencyReport(inputProcessor);
       // 禁用当前设备
       deviceManager.enableDevice(devices[currentDeviceIndex], false);
       
@@ -153,14 +308,34 @@ int main() {
       lastSwitchTime = currentTime;
     }
 
-    // 获取所有设备的事件
-    auto events = deviceManager.pollEvents();
-    handleEvents(events,inputProcessor);
+    // 取出采样线程在本帧内积累的所有事件
+    deviceManager.pollEvents(events);
+    recorder.record(events);
+    conditioner.condition(events);
+    gestures.recognize(events, currentTime);
+    coalescer.coalesce(events);
+    {
+      MetricsTimer frameTimer(MetricHistogram::FrameNanos);
+      handleEvents(events,inputProcessor);
+      inputProcessor.endFrame(); // 发布本帧的动作状态
+    }
+    inputProcessor.dispatchCommands(); // Deferred 模式下在此执行本帧的命令
 
   
     // 控制帧率
     std::this_thread::sleep_for(std::chrono::milliseconds(16));
   }
 
+  deviceManager.stopSampling();
+  recorder.close();
+  if (!options.metricsPath.empty()) {
+    std::ofstream metricsFile(options.metricsPath);
+    if (metricsFile) {
+      metricsFile << InputMetrics::snapshot().toJson() << std::endl;
+    } else {
+      std::cerr << "Error: Could not write metrics file: " << options.metricsPath << std::endl;
+    }
+  }
+  InputLog::instance().stop();
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,15 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+// 堆分配计数：链接了 AllocationCounter.cpp 的程序替换全局 operator new，
+// 统计进程内所有线程的分配次数。替换函数单独放在一个编译单元中，
+// 避免编译器把内联后的 malloc/free 与 new/delete 配对比较而产生误报
+namespace AllocationCounter {
+
+uint64_t count();
+
+} // namespace AllocationCounter
+
+#endif // ALLOCATION_COUNTER_H
@@ -0,0 +1,97 @@
+// 模拟量调理的按下/松开往返测试：松开（原始值 0）必须输出恰好 0，
+// 且松开后的下一次按下与第一次按下的输出相同（平滑状态已清空）。
+// 每个 CPU 支持的指令集各跑一遍。失败时返回非 0。
+
+#include "AnalogConditioner.h"
+#include "InputClock.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr int kStick = 1001;
+constexpr int kStickY = 1002;
+
+DeviceEvent sample(int code, float value, uint64_t timestamp) {
+    DeviceEvent event{};
+    event.device = DeviceType::Touch;
+    event.type = EventType::Directional;
+    event.code = code;
+    event.value = value;
+    event.timestamp = timestamp;
+    return event;
+}
+
+// 与随附的 bindings.json 相同的摇杆配置
+AnalogProfile stickProfile(AnalogSmoothing smoothing, int radialPair) {
+    AnalogProfile profile;
+    profile.deadzone = 0.15f;
+    profile.outerDeadzone = 0.95f;
+    profile.curve = 0.3f;
+    profile.smoothing = smoothing;
+    profile.cutoff = 1.0f;
+    profile.beta = 0.05f;
+    profile.radialPair = radialPair;
+    return profile;
+}
+
+bool checkRoundTrips(SimdLevel level, AnalogSmoothing smoothing, const char* name) {
+    AnalogConditioner conditioner;
+    conditioner.setSimdLevel(level);
+    conditioner.setProfile(DeviceType::Touch, kStick, stickProfile(smoothing, kStickY));
+    conditioner.setProfile(DeviceType::Touch, kStickY, stickProfile(smoothing, kStick));
+
+    // 每 300ms 交替按下与松开，Y 轴始终保持半推，径向死区读到的另一轴不为 0
+    std::vector<DeviceEvent> events;
+    float firstPress = 0.0f;
+    for (int i = 0; i < 8; ++i) {
+        const uint64_t timestamp = 1 + static_cast<uint64_t>(i) * 300 * kNanosPerMilli;
+        const float raw = (i % 2 == 0) ? 1.0f : 0.0f;
+        events.assign({sample(kStickY, 0.5f, timestamp), sample(kStick, raw, timestamp)});
+        conditioner.condition(events);
+        const float out = events[1].value;
+
+        if (raw == 0.0f && out != 0.0f) {
+            std::fprintf(stderr, "Error: %s/%s: release %d came out as %f\n", simdLevelToString(level), name, i,
+                         static_cast<double>(out));
+            return false;
+        }
+        if (raw != 0.0f) {
+            if (i == 0) firstPress = out;
+            if (out == 0.0f || out != firstPress) {
+                std::fprintf(stderr, "Error: %s/%s: press %d came out as %f, first press was %f\n",
+                             simdLevelToString(level), name, i, static_cast<double>(out),
+                             static_cast<double>(firstPress));
+                return false;
+            }
+        }
+    }
+
+    // 同一帧内按下后立即松开：松开仍然为 0
+    events.assign({sample(kStick, 1.0f, 10000 * kNanosPerMilli), sample(kStick, 0.0f, 10000 * kNanosPerMilli + 1)});
+    conditioner.condition(events);
+    if (events[1].value != 0.0f) {
+        std::fprintf(stderr, "Error: %s/%s: same-frame release came out as %f\n", simdLevelToString(level), name,
+                     static_cast<double>(events[1].value));
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    int checked = 0;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE, SimdLevel::AVX2}) {
+        if (AnalogKernels::select(level).level != level) continue;
+        if (!checkRoundTrips(level, AnalogSmoothing::None, "none") ||
+            !checkRoundTrips(level, AnalogSmoothing::LowPass, "lowPass") ||
+            !checkRoundTrips(level, AnalogSmoothing::OneEuro, "oneEuro")) {
+            return 1;
+        }
+        ++checked;
+    }
+    std::printf("analog press/release round trips: %d instruction set(s) checked\n", checked);
+    return 0;
+}
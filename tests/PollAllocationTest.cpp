@@ -0,0 +1,88 @@
+// 轮询路径零分配测试：预热之后，DeviceManager::pollEvents(std::vector&) 的稳态调用
+// （适配器轮询、输入流取出、多路归并）不应再有任何堆分配。失败时返回非 0。
+
+#include "AllocationCounter.h"
+#include "DeviceManager.h"
+#include "GamepadAdapter.h"
+#include "KeyboardAdapter.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr int kWarmupPolls = 64;
+constexpr int kMeasuredPolls = 1000;
+constexpr int kEventsPerPoll = 64;
+
+// 每次轮询输出固定数量的事件，时间戳交错，保证归并路径被完整执行
+class BurstAdapter : public IDeviceAdapter {
+public:
+    BurstAdapter(DeviceType type, uint32_t instanceId) : IDeviceAdapter(type, instanceId) {}
+
+    void pollInto(EventSink& sink) override {
+        for (int i = 0; i < kEventsPerPoll; ++i) {
+            DeviceEvent event{};
+            event.device = deviceType();
+            event.type = EventType::Button;
+            event.code = 32;
+            event.value = (i & 1) ? 0.0f : 1.0f;
+            event.timestamp = clock + static_cast<uint64_t>(i) * 2 + instanceId();
+            sink.push(event);
+        }
+        clock += kEventsPerPoll * 2;
+    }
+
+private:
+    uint64_t clock = 1;
+};
+
+} // namespace
+
+int main() {
+    DeviceManager& manager = DeviceManager::instance();
+    manager.registerAdapter(std::make_shared<BurstAdapter>(DeviceType::Keyboard, 1));
+    manager.registerAdapter(std::make_shared<BurstAdapter>(DeviceType::Touch, 1));
+    manager.registerAdapter(std::make_shared<KeyboardAdapter>(0, 7));
+    manager.registerAdapter(std::make_shared<GamepadAdapter>(0, 7));
+
+    std::vector<DeviceEvent> events;
+    uint64_t streamClock = 1;
+    auto frame = [&]() {
+        // 其他线程投递的事件走输入流，同样参与归并
+        for (int i = 0; i < kEventsPerPoll / 4; ++i) {
+            DeviceEvent event{};
+            event.device = DeviceType::Touch;
+            event.type = EventType::Directional;
+            event.code = 1001;
+            event.value = 0.5f;
+            event.timestamp = streamClock++;
+            manager.submitEvent(event);
+        }
+        manager.pollEvents(events);
+    };
+
+    for (int i = 0; i < kWarmupPolls; ++i) frame();
+
+    size_t polled = 0;
+    const uint64_t before = AllocationCounter::count();
+    for (int i = 0; i < kMeasuredPolls; ++i) {
+        frame();
+        polled += events.size();
+    }
+    const uint64_t allocations = AllocationCounter::count() - before;
+
+    std::printf("pollEvents: %d polls, %zu events, %llu allocations\n", kMeasuredPolls, polled,
+                static_cast<unsigned long long>(allocations));
+    if (polled == 0) {
+        std::fprintf(stderr, "Error: no events were polled\n");
+        return 1;
+    }
+    if (allocations != 0) {
+        std::fprintf(stderr, "Error: steady-state pollEvents allocated %llu times\n",
+                     static_cast<unsigned long long>(allocations));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,228 @@
+// 回滚确定性测试：历史中的事件不做任何修改时，InputHistory::resimulate 重新模拟得到的
+// 每一帧动作状态和执行的命令（含连招识别出的合成动作）必须与首次处理完全一致。
+// 另检查超出回滚快照容量的连招在编译时被拒绝。失败时返回非 0。
+
+#include "ActionMap.h"
+#include "ConflictResolver.h"
+#include "InputClock.h"
+#include "InputHistory.h"
+#include "InputProcessor.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr size_t kFrames = 240;
+constexpr size_t kEventsPerFrame = 6;
+constexpr uint64_t kEventSpacing = 7 * kNanosPerMilli;
+
+struct RecordedCommand {
+    uint64_t frame;
+    ActionId action;
+    DeviceType device;
+    EventType type;
+    int code;
+    float value;
+    uint64_t timestamp;
+
+    bool operator==(const RecordedCommand& other) const {
+        return frame == other.frame && action == other.action && device == other.device && type == other.type &&
+               code == other.code && value == other.value && timestamp == other.timestamp;
+    }
+};
+
+struct Recorder {
+    uint64_t frame = 0;
+    std::vector<RecordedCommand> commands;
+    std::vector<ActionFrame> frames; // 按帧号下标保存已发布的帧
+};
+
+void recordCommand(void* context, const ActionCommand& command) {
+    Recorder& recorder = *static_cast<Recorder*>(context);
+    const DeviceEvent& e = command.source;
+    recorder.commands.push_back({recorder.frame, command.action, e.device, e.type, e.code, e.value, e.timestamp});
+}
+
+void recordPublished(Recorder& recorder, const InputProcessor& processor) {
+    ActionStateView view = processor.getActionState().read();
+    if (recorder.frames.size() <= view->frameNumber) recorder.frames.resize(view->frameNumber + 1);
+    recorder.frames[view->frameNumber] = *view;
+}
+
+// 固定种子的按键/方向/触摸事件流：按键集中在连招用到的几个动作上，保证连招频繁完成，
+// 并且有跨越帧边界（进而跨越回滚起点）的进行中连招
+std::vector<std::vector<DeviceEvent>> makeFrames() {
+    uint32_t seed = 0x2545F491u;
+    auto next = [&seed]() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    };
+    bool down[4] = {};
+    bool touching = false;
+    uint64_t timestamp = 1;
+    std::vector<std::vector<DeviceEvent>> frames(kFrames);
+    for (std::vector<DeviceEvent>& frame : frames) {
+        for (size_t i = 0; i < kEventsPerFrame; ++i) {
+            DeviceEvent event{};
+            event.timestamp = timestamp;
+            timestamp += kEventSpacing;
+            const uint32_t roll = next() % 16;
+            if (roll < 12) {
+                const size_t key = roll % 4;
+                event.device = DeviceType::Keyboard;
+                event.type = EventType::Button;
+                event.code = 1 + static_cast<int>(key);
+                down[key] = !down[key];
+                event.value = down[key] ? 1.0f : 0.0f;
+            } else if (roll < 14) {
+                event.device = DeviceType::Keyboard;
+                event.type = EventType::Directional;
+                event.code = 10;
+                event.value = static_cast<float>(next() % 3) - 1.0f;
+            } else {
+                event.device = DeviceType::Touch;
+                touching = !touching;
+                event.type = touching ? EventType::TouchDown : EventType::TouchUp;
+                event.code = 1001;
+                event.value = touching ? 1.0f : 0.0f;
+            }
+            frame.push_back(event);
+        }
+    }
+    return frames;
+}
+
+bool expectSameFrames(const Recorder& original, const Recorder& replay, uint64_t from, uint64_t to) {
+    for (uint64_t f = from; f <= to; ++f) {
+        if (f >= replay.frames.size() || replay.frames[f].frameNumber != f ||
+            std::memcmp(&original.frames[f], &replay.frames[f], sizeof(ActionFrame)) != 0) {
+            std::fprintf(stderr, "Error: resimulated action frame %llu differs from the original\n",
+                         static_cast<unsigned long long>(f));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool expectSameCommands(const Recorder& original, const Recorder& replay, uint64_t from) {
+    std::vector<RecordedCommand> expected;
+    for (const RecordedCommand& command : original.commands) {
+        if (command.frame >= from) expected.push_back(command);
+    }
+    if (expected.size() != replay.commands.size()) {
+        std::fprintf(stderr, "Error: resimulation from frame %llu executed %zu commands, expected %zu\n",
+                     static_cast<unsigned long long>(from), replay.commands.size(), expected.size());
+        return false;
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (!(expected[i] == replay.commands[i])) {
+            std::fprintf(stderr, "Error: resimulation from frame %llu: command %zu differs from the original\n",
+                         static_cast<unsigned long long>(from), i);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    BindingTable::Builder builder;
+    const ActionId back = builder.internAction("MoveBackward");
+    const ActionId forward = builder.internAction("MoveForward");
+    const ActionId attack = builder.internAction("Attack");
+    const ActionId jump = builder.internAction("Jump");
+    const ActionId steer = builder.internAction("Steer");
+    const ActionId tap = builder.internAction("Tap");
+    builder.addBinding(DeviceType::Keyboard, 1, back);
+    builder.addBinding(DeviceType::Keyboard, 2, forward);
+    builder.addBinding(DeviceType::Keyboard, 3, attack);
+    builder.addBinding(DeviceType::Keyboard, 4, jump);
+    builder.addBinding(DeviceType::Keyboard, 10, steer);
+    builder.addBinding(DeviceType::Touch, 1001, tap);
+
+    const ActionId dashAttack = builder.internAction("DashAttack");
+    builder.addCombo({dashAttack, ComboKind::Sequence, 600 * kNanosPerMilli, {back, forward, attack}});
+    const ActionId flurry = builder.internAction("Flurry");
+    builder.addCombo({flurry, ComboKind::Sequence, 800 * kNanosPerMilli, {attack, forward, attack}});
+    const ActionId longJump = builder.internAction("LongJump");
+    builder.addCombo({longJump, ComboKind::Chord, 80 * kNanosPerMilli, {forward, jump}});
+    // 超出回滚快照容量，编译时应被拒绝
+    const ActionId tooLong = builder.internAction("TooLong");
+    builder.addCombo({tooLong, ComboKind::Sequence, 5000 * kNanosPerMilli,
+                      std::vector<ActionId>(ComboAutomaton::kMaxSequenceSteps + 1, attack)});
+
+    auto table = std::make_shared<const BindingTable>(builder.build());
+    for (const ComboDefinition& combo : table->combos().combos()) {
+        if (combo.action == tooLong) {
+            std::fprintf(stderr, "Error: a combo longer than the rollback snapshot was compiled\n");
+            return 1;
+        }
+    }
+    if (table->combos().combos().size() != 3) {
+        std::fprintf(stderr, "Error: expected 3 compiled combos, got %zu\n", table->combos().combos().size());
+        return 1;
+    }
+    ActionMap::instance().publish(table);
+
+    InputProcessor processor(ActionMap::instance());
+    processor.addConflictStrategy(std::make_shared<TouchVsDirectionalStrategy>());
+    processor.addConflictStrategy(std::make_shared<LastInputWinsStrategy>());
+    Recorder original;
+    processor.getCommandHandlers().setDefaultHandler(&recordCommand, &original);
+
+    const std::vector<std::vector<DeviceEvent>> frames = makeFrames();
+    InputHistory history(kFrames);
+    for (const std::vector<DeviceEvent>& events : frames) {
+        original.frame = processor.getActionState().pending().frameNumber;
+        const uint64_t frame = history.process(processor, events);
+        if (frame != original.frame) {
+            std::fprintf(stderr, "Error: unexpected frame number %llu\n", static_cast<unsigned long long>(frame));
+            return 1;
+        }
+        recordPublished(original, processor);
+    }
+
+    size_t comboCommands[3] = {};
+    for (const RecordedCommand& command : original.commands) {
+        if (command.action == dashAttack) ++comboCommands[0];
+        if (command.action == flurry) ++comboCommands[1];
+        if (command.action == longJump) ++comboCommands[2];
+    }
+    std::printf("original run: %zu frames, %zu commands, combos %zu/%zu/%zu\n", frames.size(),
+                original.commands.size(), comboCommands[0], comboCommands[1], comboCommands[2]);
+    if (comboCommands[0] == 0 || comboCommands[1] == 0 || comboCommands[2] == 0) {
+        std::fprintf(stderr, "Error: the event stream did not complete every combo\n");
+        return 1;
+    }
+
+    // 从历史中的每一帧分别回滚：总有回滚起点落在进行中的连招里。
+    // 每次重新模拟后状态回到原来的最新帧，下一次回滚的前提不变
+    const uint64_t latest = history.latestFrame();
+    size_t replayedCommands = 0;
+    Recorder replay;
+    for (uint64_t from = history.oldestFrame(); from <= latest; ++from) {
+        replay.commands.clear();
+        processor.getCommandHandlers().setDefaultHandler(&recordCommand, &replay);
+        const bool ok = history.resimulate(processor, from, [&](uint64_t frame, std::vector<DeviceEvent>&) {
+            if (frame != from) recordPublished(replay, processor);
+            replay.frame = frame;
+        });
+        if (!ok) {
+            std::fprintf(stderr, "Error: frame %llu is not in the history\n", static_cast<unsigned long long>(from));
+            return 1;
+        }
+        recordPublished(replay, processor);
+        if (!expectSameFrames(original, replay, from, latest) || !expectSameCommands(original, replay, from)) {
+            return 1;
+        }
+        replayedCommands += replay.commands.size();
+    }
+    std::printf("resimulated from each of %zu frames: %zu commands match\n", history.size(), replayedCommands);
+    return 0;
+}
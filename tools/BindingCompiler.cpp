@@ -0,0 +1,55 @@
+// 绑定编译器：把 bindings.json 编译为可直接内存映射的预编译绑定文件
+//
+// 用法: bindc <bindings.json> [output.bindc]
+//
+// 输出路径缺省为与输入同名、扩展名为 .bindc 的文件，ActionMap::reload 会优先
+// 使用它；源 JSON 的大小或修改时间变化后，运行时自动回退到解析 JSON。
+
+#include "ActionMap.h"
+#include "BindingTable.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: bindc <bindings.json> [output.bindc]" << std::endl;
+        return 1;
+    }
+    const std::string sourcePath = argv[1];
+    const std::string outputPath = argc == 3 ? argv[2] : ActionMap::compiledBindingsPath(sourcePath);
+
+    BindingSourceStamp stamp;
+    if (!BindingSourceStamp::of(sourcePath, stamp)) {
+        std::cerr << "Error: Could not stat bindings file: " << sourcePath << std::endl;
+        return 1;
+    }
+
+    std::shared_ptr<const BindingTable> table = ActionMap::loadBindings(sourcePath);
+    if (!table) {
+        return 1;
+    }
+
+    // 先写临时文件再改名，避免运行中的程序映射到写了一半的文件
+    const std::string tempPath = outputPath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open() || !table->writeImage(out, stamp)) {
+            std::cerr << "Error: Could not write compiled bindings: " << tempPath << std::endl;
+            return 1;
+        }
+    }
+    if (std::rename(tempPath.c_str(), outputPath.c_str()) != 0) {
+        std::cerr << "Error: Could not rename " << tempPath << " to " << outputPath << std::endl;
+        std::remove(tempPath.c_str());
+        return 1;
+    }
+
+    size_t bindingCount = 0;
+    table->forEachBinding([&](DeviceType, int, ActionIdSpan) { ++bindingCount; });
+    std::cout << "Compiled " << table->actionCount() << " actions, " << bindingCount
+              << " bindings -> " << outputPath << std::endl;
+    return 0;
+}